@@ -12,6 +12,11 @@
 
 #include "buffer/buffer_pool_manager.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
 #include "common/exception.h"
 #include "common/macros.h"
 #include "storage/page/page_guard.h"
@@ -20,156 +25,432 @@ namespace bustub {
 
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
                                      LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // we allocate a consecutive memory space for the buffer pool
+    : pool_size_(pool_size),
+      instance_id_([] {
+        static std::atomic<uint64_t> next_instance{0};
+        return next_instance.fetch_add(1, std::memory_order_relaxed) + 1;
+      }()),
+      disk_manager_(disk_manager),
+      log_manager_(log_manager),
+      free_frames_(pool_size) {
+  // we allocate a consecutive memory space for the buffer pool: page data lives in one
+  // page-aligned slab so frame data is contiguous (sequential flushes walk a linear region and
+  // the alignment suits direct I/O), while the Page metadata array stays separate and dense
   pages_ = new Page[pool_size_];
+  page_data_ = static_cast<char *>(std::aligned_alloc(BUSTUB_PAGE_SIZE, pool_size_ * BUSTUB_PAGE_SIZE));
+  for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].SetDataBuffer(page_data_ + i * BUSTUB_PAGE_SIZE);
+  }
   replacer_ = std::make_unique<LRUKReplacer>(pool_size, replacer_k);
 
-  // Initially, every page is in the free list.
-  for (size_t i = 0; i < pool_size_; ++i) {
-    free_list_.emplace_back(static_cast<int>(i));
+  // Size every partition table for the worst case where all resident pages hash to one
+  // partition, so the per-slice load factor can never exceed 0.5 either.
+  partitions_.reserve(BPM_PARTITIONS);
+  for (size_t i = 0; i < BPM_PARTITIONS; ++i) {
+    partitions_.emplace_back(std::make_unique<Partition>(pool_size));
+  }
+  // Initially, every page is on the free frame stack.
+  for (size_t i = pool_size_; i > 0; --i) {
+    free_frames_.Push(static_cast<frame_id_t>(i - 1));
+  }
+
+  flush_ring_.resize(std::max<size_t>(1, std::min(pool_size_, FLUSH_RING_CAPACITY)));
+  for (auto &slot : flush_ring_) {
+    slot.data_ = std::make_unique<char[]>(BUSTUB_PAGE_SIZE);
   }
+  flusher_thread_ = std::thread([this] { FlusherLoop(); });
 }
 
-BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
+BufferPoolManager::~BufferPoolManager() {
+  {
+    std::scoped_lock lock(flush_latch_);
+    flush_shutdown_ = true;
+  }
+  flush_cv_.notify_all();
+  flusher_thread_.join();  // the flusher drains every staged write before exiting
+  delete[] pages_;
+  std::free(page_data_);
+}
 
-auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
-  frame_id_t fid = -1;
-  Page *ptr = nullptr;
-  // access free_list, lock it
-  latch_.lock();
-  if (!free_list_.empty()) {
-    fid = free_list_.back();
-    free_list_.pop_back();
-    latch_.unlock();
-    ptr = pages_ + fid;
-  } else {
+auto BufferPoolManager::TryStageEvictionWrite(page_id_t page_id, const char *data) -> bool {
+  std::unique_lock lock(flush_latch_);
+  if (flush_size_ >= flush_ring_.size()) {
+    return false;  // ring full; the caller must wait outside its spin latch and retry
+  }
+  auto &slot = flush_ring_[(flush_head_ + flush_size_) % flush_ring_.size()];
+  slot.page_id_ = page_id;
+  std::memcpy(slot.data_.get(), data, BUSTUB_PAGE_SIZE);
+  ++flush_size_;
+  ++stage_seq_;
+  flush_cv_.notify_all();
+  return true;
+}
+
+void BufferPoolManager::WaitForFlushSpace() {
+  std::unique_lock lock(flush_latch_);
+  flush_cv_.wait(lock, [this] { return flush_size_ < flush_ring_.size(); });
+}
+
+auto BufferPoolManager::TryReadStaged(page_id_t page_id, char *data) -> bool {
+  std::unique_lock lock(flush_latch_);
+  flush_cv_.wait(lock, [this, page_id] {
+    return std::find(inflight_pids_.begin(), inflight_pids_.end(), page_id) == inflight_pids_.end();
+  });
+  // scan newest to oldest so we reclaim the latest staged copy
+  for (size_t i = flush_size_; i > 0; --i) {
+    auto &slot = flush_ring_[(flush_head_ + i - 1) % flush_ring_.size()];
+    if (slot.page_id_ == page_id) {
+      std::memcpy(data, slot.data_.get(), BUSTUB_PAGE_SIZE);
+      slot.page_id_ = INVALID_PAGE_ID;  // cancel; the resident copy is the truth again
+      return true;
+    }
+  }
+  return false;
+}
+
+void BufferPoolManager::CancelStaged(page_id_t page_id) {
+  std::unique_lock lock(flush_latch_);
+  flush_cv_.wait(lock, [this, page_id] {
+    return std::find(inflight_pids_.begin(), inflight_pids_.end(), page_id) == inflight_pids_.end();
+  });
+  for (size_t i = 0; i < flush_size_; ++i) {
+    auto &slot = flush_ring_[(flush_head_ + i) % flush_ring_.size()];
+    if (slot.page_id_ == page_id) {
+      slot.page_id_ = INVALID_PAGE_ID;
+    }
+  }
+}
+
+void BufferPoolManager::DrainFlushRing() {
+  std::unique_lock lock(flush_latch_);
+  flush_cv_.wait(lock, [this] { return flush_size_ == 0 && inflight_pids_.empty(); });
+}
+
+void BufferPoolManager::DrainIfPending() {
+  std::unique_lock lock(flush_latch_);
+  const size_t target = stage_seq_;
+  if (flushed_seq_ >= target) {
+    return;
+  }
+  flush_cv_.wait(lock, [this, target] { return flushed_seq_ >= target; });
+}
+
+void BufferPoolManager::FlusherLoop() {
+  const size_t capacity = flush_ring_.size();
+  // one scratch area holds a whole claimed batch, the other gathers each contiguous run of it
+  auto batch_buf = std::make_unique<char[]>(capacity * BUSTUB_PAGE_SIZE);
+  auto run_buf = std::make_unique<char[]>(capacity * BUSTUB_PAGE_SIZE);
+  std::vector<std::pair<page_id_t, size_t>> entries;  // page id -> its page index in batch_buf
+  std::unique_lock lock(flush_latch_);
+  for (;;) {
+    flush_cv_.wait(lock, [this] { return flush_size_ > 0 || flush_shutdown_; });
+    if (flush_size_ == 0) {
+      return;  // shut down only once every staged write has been drained
+    }
+    // claim everything staged so far as one batch; copying out frees the ring immediately
+    entries.clear();
+    const size_t batch = flush_size_;
+    for (size_t i = 0; i < batch; ++i) {
+      auto &slot = flush_ring_[flush_head_];
+      if (slot.page_id_ != INVALID_PAGE_ID) {
+        std::memcpy(batch_buf.get() + entries.size() * BUSTUB_PAGE_SIZE, slot.data_.get(), BUSTUB_PAGE_SIZE);
+        inflight_pids_.push_back(slot.page_id_);
+        entries.emplace_back(slot.page_id_, entries.size());
+        slot.page_id_ = INVALID_PAGE_ID;
+      }
+      flush_head_ = (flush_head_ + 1) % capacity;
+      --flush_size_;
+    }
+    flush_cv_.notify_all();
+    if (entries.empty()) {
+      flushed_seq_ += batch;  // every claimed slot was cancelled, but it is still retired
+      continue;
+    }
+    lock.unlock();
+    // sort by page id so neighbouring pages coalesce into single contiguous writes; a stable
+    // sort keeps staging order within one page id, so its newest copy wins the gather below
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+    for (size_t i = 0; i < entries.size();) {
+      const page_id_t first_pid = entries[i].first;
+      size_t run_len = 0;
+      while (i < entries.size()) {
+        const auto offset = static_cast<size_t>(entries[i].first - first_pid);
+        if (offset > run_len) {
+          break;  // gap in page ids, the run ends here
+        }
+        // offset == run_len extends the run; offset < run_len overwrites a duplicate page id
+        std::memcpy(run_buf.get() + offset * BUSTUB_PAGE_SIZE, batch_buf.get() + entries[i].second * BUSTUB_PAGE_SIZE,
+                    BUSTUB_PAGE_SIZE);
+        run_len = std::max(run_len, offset + 1);
+        ++i;
+      }
+      disk_manager_->WritePages(first_pid, run_buf.get(), run_len);
+    }
+    lock.lock();
+    // remove exactly the pids this batch registered; solo evictors park their own inflight
+    // entries here too and those must survive until their synchronous writes land
+    for (const auto &entry : entries) {
+      inflight_pids_.erase(std::find(inflight_pids_.begin(), inflight_pids_.end(), entry.first));
+    }
+    flushed_seq_ += batch;
+    flush_cv_.notify_all();
+  }
+}
+
+auto BufferPoolManager::AcquireFrame(frame_id_t *frame_id) -> bool {
+  // An empty stack plus an empty replacer does not mean the pool is pinned out: frames travel
+  // between the two through private hands (an evictor rebinding its victim, an unpin landing just
+  // after our probe). The counter is raised *before* each attempt so any frame we might have
+  // grabbed stays accounted for while it is in transit, and exhaustion is only reported after the
+  // pool has looked empty for many consecutive probes — a genuinely pinned-out pool stays empty
+  // forever, while a momentary gap between one thread's release and our probe cannot.
+  constexpr int EXHAUSTION_PROBES = 1024;
+  for (int idle_probes = 0;;) {
+    frames_in_transit_.fetch_add(1, std::memory_order_acq_rel);
+    if (free_frames_.Pop(frame_id)) {
+      return true;  // stays counted until the caller republishes the frame
+    }
+    if (EvictFrame(frame_id)) {
+      return true;
+    }
+    frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);
+    if (frames_in_transit_.load(std::memory_order_acquire) == 0) {
+      if (++idle_probes >= EXHAUSTION_PROBES) {
+        return false;  // nothing free, nothing evictable, nothing in transit: the pool is pinned out
+      }
+    } else {
+      idle_probes = 0;  // someone is mid-transfer; their frame will be republished shortly
+    }
+    std::this_thread::yield();
+  }
+}
+
+auto BufferPoolManager::EvictFrame(frame_id_t *frame_id) -> bool {
+  for (;;) {
+    frame_id_t fid = -1;
     if (!replacer_->Evict(&fid)) {
-      // free list is empty and no evictable
-      latch_.unlock();
-      return nullptr;
+      return false;  // no free frame and nothing evictable
     }
-    ptr = pages_ + fid;
-    if (ptr->page_id_ != INVALID_PAGE_ID) {  // remove relation between old page id and fid
-      page_table_.erase(ptr->page_id_);
+    auto ptr = pages_ + fid;
+    // Evict alone does not make us the exclusive evictor: a pin/unpin cycle re-registers the
+    // frame and a second thread may win another Evict before this claim resolves. The claim
+    // flag elects one owner; the loser's pop is moot (the winner recycles the frame).
+    bool expected = false;
+    if (!ptr->evict_claim_.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+      continue;
     }
-    // flush dirty page
-    if (ptr->is_dirty_) {
-      disk_manager_->WritePage(ptr->page_id_, ptr->data_);
+    // page_id_ is only rewritten by a thread that owns the frame privately, and holding the
+    // claim flag excludes every other evictor, so this read is stable.
+    page_id_t old_pid = ptr->page_id_;
+    if (old_pid != INVALID_PAGE_ID) {
+      auto &part = PartitionOf(old_pid);
+      bool abandoned = false;
+      for (;;) {
+        part.latch_.lock();
+        if (ptr->pin_count_ > 0) {
+          // A fetch hit re-pinned the page between Evict and here; abandon the claim. The
+          // pinning thread recorded a fresh access and the next unpin re-registers the frame.
+          part.latch_.unlock();
+          abandoned = true;
+          break;
+        }
+        if (ptr->is_dirty_) {
+          if (active_calls_.load(std::memory_order_relaxed) == 1) {
+            // we are the only caller, so a staged write would just be drained the moment this
+            // call returns; write through directly instead of bouncing it off the flusher. The
+            // inflight entry keeps a re-fetch of old_pid (from a call starting mid-write) from
+            // reading stale bytes off disk before this write lands.
+            {
+              std::scoped_lock flush_lock(flush_latch_);
+              inflight_pids_.push_back(old_pid);
+            }
+            part.table_.Erase(old_pid);
+            part.latch_.unlock();
+            disk_manager_->WritePage(old_pid, ptr->data_);
+            {
+              std::scoped_lock flush_lock(flush_latch_);
+              inflight_pids_.erase(std::find(inflight_pids_.begin(), inflight_pids_.end(), old_pid));
+            }
+            flush_cv_.notify_all();
+            break;
+          }
+          // park dirty victims in the flush ring so the frame is reusable right away; stage in
+          // the same critical section as the mapping removal so a concurrent re-fetch of old_pid
+          // cannot slip in between and read stale bytes from disk
+          if (!TryStageEvictionWrite(old_pid, ptr->data_)) {
+            // the ring is full; never block under a spin latch, wait outside and retry
+            part.latch_.unlock();
+            WaitForFlushSpace();
+            continue;
+          }
+        }
+        // The mapping may already be gone if a concurrent DeletePage lost the TryRemove race;
+        // either way the frame is exclusively ours from this point on.
+        part.table_.Erase(old_pid);
+        part.latch_.unlock();
+        break;
+      }
+      if (abandoned) {
+        ptr->evict_claim_.store(false, std::memory_order_release);
+        continue;
+      }
     }
-    latch_.unlock();  // only now, other threads will not access page ptr, we own this page now
+    // A pin/unpin cycle between Evict and the mapping removal may have re-registered the frame;
+    // strip that stale registration before releasing the claim, otherwise a later Evict could
+    // hand out the frame while our caller privately rebinds it.
+    replacer_->TryRemove(fid);
+    ptr->evict_claim_.store(false, std::memory_order_release);
+    *frame_id = fid;
+    return true;
+  }
+}
+
+void BufferPoolManager::WaitForLoad(Page *page) {
+  if (!page->io_in_progress_.load(std::memory_order_acquire)) {
+    return;  // fast path: no load in flight
+  }
+  std::unique_lock lock(io_latch_);
+  io_cv_.wait(lock, [page] { return !page->io_in_progress_.load(std::memory_order_acquire); });
+}
+
+void BufferPoolManager::FinishLoad(Page *page) {
+  {
+    std::scoped_lock lock(io_latch_);
+    page->io_in_progress_.store(false, std::memory_order_release);
+  }
+  io_cv_.notify_all();
+}
+
+void BufferPoolManager::ReleaseFrame(frame_id_t frame_id) {
+  auto ptr = pages_ + frame_id;
+  // no ResetMemory: whoever takes the frame next either zeroes it (NewPage) or overwrites the
+  // whole page from disk (FetchPage miss), so clearing 4KB here would be dead stores
+  ptr->page_id_ = INVALID_PAGE_ID;
+  ptr->pin_count_ = 0;
+  ptr->is_dirty_ = false;
+  free_frames_.Push(frame_id);
+}
+
+auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
+  ApiCallScope scope(this);
+  frame_id_t fid = -1;
+  if (!AcquireFrame(&fid)) {
+    return nullptr;
   }
-  // reset memory and metadata
+  // we own this frame now, no other thread can access it until the mapping is published
+  auto ptr = pages_ + fid;
   ptr->ResetMemory();
   ptr->page_id_ = AllocatePage();
   ptr->pin_count_ = 1;
   ptr->is_dirty_ = false;
-  latch_.lock();
-  page_table_[ptr->page_id_] = fid;
+  auto &part = PartitionOf(ptr->page_id_);
+  part.latch_.lock();
+  part.table_.Insert(ptr->page_id_, fid);
+  part.latch_.unlock();
+  frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);  // republished: mapped and pinned
   // lru policy helper
   replacer_->SetEvictable(fid, false);  // Pin page
   replacer_->RecordAccess(fid);
-  latch_.unlock();
 
   *page_id = ptr->page_id_;
   return ptr;
 }
 
 auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
+  ApiCallScope scope(this);
+  // Each path below holds its partition latch for exactly one critical section: the hit path pins
+  // under the lookup latch, the miss path publishes the mapping under one re-acquisition after the
+  // latch-free frame allocation. RecordAccess batches internally, so no lock is taken for it.
   frame_id_t fid = -1;
   Page *ptr = nullptr;
-  latch_.lock();
-  auto iter = page_table_.find(page_id);
-  if (iter != page_table_.end()) {
-    fid = iter->second;
+  auto &part = PartitionOf(page_id);
+  part.table_.Prefetch(page_id);  // pull the home cache line in before taking the latch
+  part.latch_.lock();
+  if (part.table_.Find(page_id, &fid)) {
     ptr = pages_ + fid;
-    ++ptr->pin_count_;  // already pinned, increase pin count
+    // already pinned, increase pin count with a single RMW
     // special case: pin count may change from 0 to 1, we should record non-evictable again!
     // because in Unpin() from 1 to 0, we just set to victable without delete from page_table_!
-    if (ptr->pin_count_ == 1) {
+    if (ptr->pin_count_.fetch_add(1, std::memory_order_acquire) == 0) {
       replacer_->SetEvictable(fid, false);
     }
-    latch_.unlock();
+    part.latch_.unlock();
+    // the frame may still be loading from disk on behalf of another fetcher
+    WaitForLoad(ptr);
   } else {
-    // alloc new page, same as NewPage()
-    if (!free_list_.empty()) {
-      fid = free_list_.back();
-      free_list_.pop_back();
-      latch_.unlock();
-      ptr = pages_ + fid;
-    } else {
-      if (!replacer_->Evict(&fid)) {
-        // free list is empty and no evictable
-        latch_.unlock();
-        return nullptr;
-      }
-      ptr = pages_ + fid;
-      // flush dirty page
-      if (ptr->is_dirty_) {
-        disk_manager_->WritePage(ptr->page_id_, ptr->data_);
-      }
-      // reset memory and metadata
-      if (ptr->page_id_ != INVALID_PAGE_ID) {  // remove relation between old page id and fid
-        page_table_.erase(ptr->page_id_);
-      }
-      latch_.unlock();
+    part.latch_.unlock();
+    // alloc new frame, same as NewPage()
+    if (!AcquireFrame(&fid)) {
+      return nullptr;
     }
-    ptr->ResetMemory();
+    ptr = pages_ + fid;
+    // no ResetMemory: ReadPage (or the reclaimed staged copy) overwrites every byte of the page
     ptr->page_id_ = page_id;
     ptr->pin_count_ = 1;
     ptr->is_dirty_ = false;
-    // load page from dict
-    disk_manager_->ReadPage(ptr->page_id_, ptr->data_);
-    latch_.lock();
-    iter = page_table_.find(page_id);
-    if (iter == page_table_.end()) {
-      page_table_[page_id] = fid;           // no conflict, just store it
+    part.latch_.lock();
+    frame_id_t existing_fid = -1;
+    if (!part.table_.Find(page_id, &existing_fid)) {
+      // publish the mapping *before* doing the disk read: concurrent fetchers of the same
+      // page find the frame, pin it and wait for the load instead of reading disk twice
+      part.table_.Insert(page_id, fid);
+      ptr->io_in_progress_.store(true, std::memory_order_release);
       replacer_->SetEvictable(fid, false);  // Pin page for first time
+      part.latch_.unlock();
+      frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);  // republished: mapped and pinned
+      // a just-evicted copy may still sit in the flush ring; reclaim it instead of hitting disk
+      if (TryReadStaged(page_id, ptr->data_)) {
+        ptr->is_dirty_ = true;  // the reclaimed copy never reached disk
+      } else {
+        // load page from dict
+        disk_manager_->ReadPage(ptr->page_id_, ptr->data_);
+      }
+      FinishLoad(ptr);
     } else {
-      // we has to return page back to freelist
-      ptr->ResetMemory();
-      ptr->page_id_ = INVALID_PAGE_ID;
-      ptr->pin_count_ = 0;
-      ptr->is_dirty_ = false;
-      free_list_.emplace_back(static_cast<int>(fid));
-      // share registered page
-      fid = iter->second;
+      // another thread registered the page while we were allocating a frame;
+      // share its frame and give our spare one back to the free list
+      frame_id_t spare_fid = fid;
+      fid = existing_fid;
       ptr = pages_ + fid;
-      ++ptr->pin_count_;  // already pinned, increase pin count
       // see comment in begin: this case happened when we reuse a Unpin page from 1 to 0,
       // evitable but still can be seen from page_table_
-      if (ptr->pin_count_ == 1) {
+      if (ptr->pin_count_.fetch_add(1, std::memory_order_acquire) == 0) {
         replacer_->SetEvictable(fid, false);  // Pin page for first time
       }
+      part.latch_.unlock();
+      WaitForLoad(ptr);
+      ReleaseFrame(spare_fid);
+      frames_in_transit_.fetch_sub(1, std::memory_order_acq_rel);  // republished: back on the free stack
     }
-    latch_.unlock();
   }
 
-  latch_.lock();
   // lru policy helper
   replacer_->RecordAccess(fid);
-  latch_.unlock();
   return ptr;
 }
 
 auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
-  latch_.lock();
-  auto iter = page_table_.find(page_id);
-  if (iter == page_table_.end()) {
-    latch_.unlock();
+  ApiCallScope scope(this);
+  auto &part = PartitionOf(page_id);
+  part.latch_.lock();
+  frame_id_t fid = -1;
+  if (!part.table_.Find(page_id, &fid)) {
+    part.latch_.unlock();
     return false;
   }
-  auto ptr = pages_ + iter->second;
-  if (ptr->pin_count_ == 0) {
-    latch_.unlock();
+  auto ptr = pages_ + fid;
+  if (ptr->pin_count_.load(std::memory_order_acquire) == 0) {
+    part.latch_.unlock();
     return false;
   }
-  --ptr->pin_count_;
-  ptr->is_dirty_ = (ptr->is_dirty_) || is_dirty;
-  if (ptr->pin_count_ == 0) {
-    replacer_->SetEvictable(iter->second, true);  // unpin page
+  if (is_dirty) {
+    ptr->is_dirty_.store(true, std::memory_order_release);  // merge, never clear
   }
-  latch_.unlock();
+  if (ptr->pin_count_.fetch_sub(1, std::memory_order_release) == 1) {
+    replacer_->SetEvictable(fid, true);  // unpin page
+  }
+  part.latch_.unlock();
   // here, we donot remove pid -> fid relation from page_table
   // because unpinned page could be fetched again if reused quickly!
   // so we has to mannually remove the relation when the page_id is changged
@@ -178,65 +459,122 @@ auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unus
 }
 
 auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
-  latch_.lock();
-  auto iter = page_table_.find(page_id);
-  if (iter == page_table_.end()) {
-    latch_.unlock();
+  ApiCallScope scope(this);
+  auto &part = PartitionOf(page_id);
+  part.latch_.lock();
+  frame_id_t fid = -1;
+  if (!part.table_.Find(page_id, &fid)) {
+    part.latch_.unlock();
     return false;
   }
-  auto ptr = pages_ + iter->second;
-  disk_manager_->WritePage(ptr->page_id_, ptr->data_);
+  auto ptr = pages_ + fid;
+  // pin the frame so it cannot be evicted while we write outside the latch
+  if (ptr->pin_count_.fetch_add(1, std::memory_order_acquire) == 0) {
+    replacer_->SetEvictable(fid, false);
+  }
+  part.latch_.unlock();
+  WaitForLoad(ptr);
+  // older staged copies must not land after this direct write
+  CancelStaged(page_id);
+  // clear the flag before the write, not after: a concurrent UnpinPage(..., true) between the
+  // two would otherwise have its re-dirty wiped and the newer contents never flushed; cleared
+  // first, the re-dirty survives and simply forces one more flush later
   ptr->is_dirty_ = false;
-  latch_.unlock();
+  disk_manager_->WritePage(page_id, ptr->data_);
+  // drop our pin again, mirroring UnpinPage
+  if (ptr->pin_count_.fetch_sub(1, std::memory_order_release) == 1) {
+    replacer_->SetEvictable(fid, true);
+  }
   return true;
 }
 
 void BufferPoolManager::FlushAllPages() {
+  ApiCallScope scope(this);
   for (auto ptr = pages_; ptr != pages_ + pool_size_; ++ptr) {
-    if (ptr->page_id_ != INVALID_PAGE_ID) {
-      latch_.lock();
-      disk_manager_->WritePage(ptr->page_id_, ptr->data_);
+    page_id_t pid = ptr->page_id_;
+    if (pid == INVALID_PAGE_ID) {
+      continue;
+    }
+    auto &part = PartitionOf(pid);
+    for (;;) {
+      part.latch_.lock();
+      if (ptr->page_id_ != pid) {
+        part.latch_.unlock();
+        break;  // frame was recycled in the meantime; eviction already staged it
+      }
+      // submit through the flush ring instead of one synchronous write per page; on a full
+      // ring wait outside the spin latch and retry
+      if (!TryStageEvictionWrite(pid, ptr->data_)) {
+        part.latch_.unlock();
+        WaitForFlushSpace();
+        continue;
+      }
       ptr->is_dirty_ = false;
-      latch_.unlock();
+      part.latch_.unlock();
+      break;
     }
   }
+  // one wait at the end instead of blocking per page
+  DrainFlushRing();
 }
 
 auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
-  latch_.lock();
-  auto iter = page_table_.find(page_id);
-  if (iter == page_table_.end()) {
-    latch_.unlock();
+  ApiCallScope scope(this);
+  auto &part = PartitionOf(page_id);
+  part.latch_.lock();
+  frame_id_t fid = -1;
+  if (!part.table_.Find(page_id, &fid)) {
+    part.latch_.unlock();
     return true;
   }
-  auto fid = iter->second;
   auto ptr = pages_ + fid;
   if (ptr->pin_count_ > 0) {
-    latch_.unlock();
+    part.latch_.unlock();
     return false;
   }
-  // page is unpined, release it
-  // reset data and meta, to be a fresh clean page
-  if (ptr->is_dirty_) {
-    disk_manager_->WritePage(ptr->page_id_, ptr->data_);
+  // page is unpined, try to claim the frame from the replacer; winning TryRemove is not enough,
+  // we must also win the claim flag in case an earlier eviction of this frame is still in flight
+  bool claimed = replacer_->TryRemove(fid);
+  if (claimed) {
+    bool expected = false;
+    claimed = ptr->evict_claim_.compare_exchange_strong(expected, true, std::memory_order_acq_rel);
+  }
+  // remove relatioin either way; a failed claim means a concurrent eviction owns the frame
+  // and will recycle it, we only have to drop the mapping here
+  part.table_.Erase(page_id);
+  bool dirty = claimed && ptr->is_dirty_;
+  part.latch_.unlock();
+  if (claimed) {
+    if (dirty) {
+      disk_manager_->WritePage(page_id, ptr->data_);
+    }
+    // reset meta, link to freelist, to be a fresh clean frame
+    ptr->evict_claim_.store(false, std::memory_order_release);
+    ReleaseFrame(fid);
   }
-  // remove relatioin, link to freelist, stop lru watch
-  page_table_.erase(page_id);
-  replacer_->Remove(fid);
-  latch_.unlock();
-  ptr->ResetMemory();
-  ptr->page_id_ = INVALID_PAGE_ID;
-  ptr->pin_count_ = 0;
-  ptr->is_dirty_ = false;
-  latch_.lock();
-  free_list_.emplace_back(static_cast<int>(fid));
-  latch_.unlock();
   // free page?
   DeallocatePage(page_id);
   return true;
 }
 
-auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
+auto BufferPoolManager::AllocatePage() -> page_id_t {
+  // Each thread reserves a block of ids with a single RMW and hands them out privately, so
+  // split-heavy insert workloads do not serialize on next_page_id_. Ids left in a block when
+  // a pool is destroyed are simply never used; the instance token keeps a block reserved
+  // against one pool from leaking into another.
+  struct IdBlock {
+    uint64_t owner{0};
+    page_id_t next{0};
+    page_id_t end{0};
+  };
+  thread_local IdBlock block;
+  if (block.owner != instance_id_ || block.next == block.end) {
+    block.owner = instance_id_;
+    block.next = next_page_id_.fetch_add(ID_ALLOC_BATCH, std::memory_order_relaxed);
+    block.end = block.next + ID_ALLOC_BATCH;
+  }
+  return block.next++;
+}
 
 auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard { return {this, FetchPage(page_id)}; }
 
@@ -244,6 +582,8 @@ auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard { retu
 
 auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard { return {this, FetchPage(page_id)}; }
 
+void BufferPoolManager::PrefetchPage(page_id_t page_id) { PartitionOf(page_id).table_.Prefetch(page_id); }
+
 auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard { return {this, NewPage(page_id)}; }
 
 }  // namespace bustub
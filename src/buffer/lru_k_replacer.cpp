@@ -11,99 +11,196 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/lru_k_replacer.h"
+
+#include <functional>
+#include <thread>  // NOLINT
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
 #include "common/exception.h"
 
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {
+  node_store_.resize(num_frames);
+  evict_key_.assign((num_frames + 3) / 4 * 4, NOT_EVICTABLE);
+  access_queues_.reserve(ACCESS_QUEUE_COUNT);
+  for (size_t i = 0; i < ACCESS_QUEUE_COUNT; ++i) {
+    access_queues_.emplace_back(std::make_unique<AccessQueue>());
+  }
+}
+
+void LRUKReplacer::DrainAccessQueues() {
+  std::vector<frame_id_t> batch;
+  for (auto &queue : access_queues_) {
+    std::scoped_lock lock(queue->latch_);
+    batch.insert(batch.end(), queue->pending_.begin(), queue->pending_.end());
+    queue->pending_.clear();
+  }
+  ApplyBatch(batch);
+}
+
+void LRUKReplacer::ApplyBatch(std::vector<frame_id_t> &batch) {
+  if (batch.empty()) {
+    return;
+  }
+  // pull the nodes of the whole batch into cache while we wait for the latch
+  for (auto frame_id : batch) {
+    __builtin_prefetch(&node_store_[frame_id]);
+  }
+  std::scoped_lock lock(latch_);
+  for (auto frame_id : batch) {
+    RecordAccessLocked(frame_id);
+  }
+}
 
 auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
-  frame_id_t fid = -1;
-  frame_id_t inf_fid = -1;
-  size_t ts = current_timestamp_ + 1;
-  size_t inf_ts = current_timestamp_ + 1;
-  for (auto it : node_store_) {
-    if (!it.second.is_evictable_) {  // skip non-evictable
-      continue;
-    }
-    if (it.second.history_.size() < k_) {  // inf
-      if (it.second.history_.empty()) {
-        inf_fid = it.first;
-        break;
-      }
-      if (it.second.history_.front() < inf_ts) {
-        inf_fid = it.first;
-        inf_ts = it.second.history_.front();
-      }
-      continue;
-    }
-    if (inf_fid != -1) {  // inf already found, skip
-      continue;
-    }
-    // common case, no inf, we compare front directly
-    if (it.second.history_.front() < ts) {
-      fid = it.first;
-      ts = it.second.history_.front();
+  // queued accesses must be visible before choosing a victim
+  DrainAccessQueues();
+  std::scoped_lock lock(latch_);
+  auto fid = FindVictim();
+  if (fid < 0) {
+    return false;
+  }
+  *frame_id = fid;
+  RemoveLocked(node_store_[fid], fid);
+  return true;
+}
+
+auto LRUKReplacer::FindVictim() -> frame_id_t {
+  // one unsigned min over the packed keys: +inf-distance frames sort below full-history ones
+  // (FULL_HISTORY_BIT), pinned and untracked frames sort last (NOT_EVICTABLE)
+  const size_t n = evict_key_.size();
+  uint64_t best = NOT_EVICTABLE;
+  size_t best_idx = n;
+#ifdef __AVX2__
+  // 4 lanes at a time; AVX2 has no unsigned 64-bit min, so flip the sign bit and compare signed
+  const __m256i sign = _mm256_set1_epi64x(static_cast<int64_t>(uint64_t{1} << 63U));
+  const __m256i four = _mm256_set1_epi64x(4);
+  __m256i vmin = _mm256_set1_epi64x(-1);
+  __m256i vmin_idx = _mm256_setzero_si256();
+  __m256i vidx = _mm256_setr_epi64x(0, 1, 2, 3);
+  for (size_t i = 0; i < n; i += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(evict_key_.data() + i));
+    __m256i less = _mm256_cmpgt_epi64(_mm256_xor_si256(vmin, sign), _mm256_xor_si256(v, sign));
+    vmin = _mm256_blendv_epi8(vmin, v, less);
+    vmin_idx = _mm256_blendv_epi8(vmin_idx, vidx, less);
+    vidx = _mm256_add_epi64(vidx, four);
+  }
+  alignas(32) uint64_t vals[4];
+  alignas(32) uint64_t idxs[4];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(vals), vmin);
+  _mm256_store_si256(reinterpret_cast<__m256i *>(idxs), vmin_idx);
+  for (auto lane = 0; lane < 4; lane++) {
+    // strict less in the loop keeps the first hit per lane; break cross-lane ties by index
+    if (vals[lane] < best || (vals[lane] == best && idxs[lane] < best_idx)) {
+      best = vals[lane];
+      best_idx = idxs[lane];
     }
   }
-  if (inf_fid != -1) {
-    *frame_id = inf_fid;
-    Remove(inf_fid);
-    return true;
+#else
+  for (size_t i = 0; i < n; i++) {
+    if (evict_key_[i] < best) {
+      best = evict_key_[i];
+      best_idx = i;
+    }
   }
-  if (fid != -1) {
-    *frame_id = fid;
-    Remove(fid);
-    return true;
+#endif
+  if (best == NOT_EVICTABLE) {
+    return -1;
   }
-  return false;
+  return static_cast<frame_id_t>(best_idx);
 }
 
 void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type) {
   if (frame_id < 0 || frame_id >= static_cast<frame_id_t>(replacer_size_)) {
     throw Exception("invlaid frame_id");
   }
-  auto iter = node_store_.find(frame_id);
-  if (iter == node_store_.end()) {
-    node_store_[frame_id] = LRUKNode();
-    iter = node_store_.find(frame_id);
+  auto &queue = *access_queues_[std::hash<std::thread::id>()(std::this_thread::get_id()) % ACCESS_QUEUE_COUNT];
+  std::vector<frame_id_t> batch;
+  {
+    std::scoped_lock lock(queue.latch_);
+    queue.pending_.push_back(frame_id);
+    if (queue.pending_.size() < ACCESS_BATCH_SIZE) {
+      return;
+    }
+    batch.swap(queue.pending_);
   }
-  iter->second.history_.push_front(++current_timestamp_);
-  if (iter->second.history_.size() > k_) {
-    iter->second.history_.pop_back();
+  ApplyBatch(batch);
+}
+
+void LRUKReplacer::RecordAccessLocked(frame_id_t frame_id) {
+  auto &node = node_store_[frame_id];
+  node.last_access_ = ++current_timestamp_;
+  if (node.history_len_ < k_) {
+    node.history_len_++;
   }
+  RefreshKey(frame_id);
 }
 
 void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
   if (frame_id < 0 || frame_id >= static_cast<frame_id_t>(replacer_size_)) {
     throw Exception("invlaid frame_id");
   }
-  auto iter = node_store_.find(frame_id);
-  if (iter == node_store_.end()) {
+  std::scoped_lock lock(latch_);
+  // a frame whose access still sits in a pending batch simply has an empty history here, which
+  // sorts as +inf backward k-distance, so it cannot escape the replacer
+  auto &node = node_store_[frame_id];
+  if (node.is_evictable_ == set_evictable) {
     return;
   }
-  if (!iter->second.is_evictable_ && set_evictable) {
+  node.is_evictable_ = set_evictable;
+  if (set_evictable) {
     ++curr_size_;
-    iter->second.is_evictable_ = set_evictable;
-  } else if (iter->second.is_evictable_ && !set_evictable) {
+  } else {
     --curr_size_;
-    iter->second.is_evictable_ = set_evictable;
   }
+  RefreshKey(frame_id);
 }
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
-  auto iter = node_store_.find(frame_id);
-  if (iter == node_store_.end()) {
+  if (frame_id < 0 || frame_id >= static_cast<frame_id_t>(replacer_size_)) {
     return;
   }
-  if (!iter->second.is_evictable_) {
+  DrainAccessQueues();
+  std::scoped_lock lock(latch_);
+  auto &node = node_store_[frame_id];
+  if (!node.is_evictable_) {
+    if (node.history_len_ == 0) {
+      return;  // never tracked, nothing to remove
+    }
     throw Exception("frame is not evictable");
   }
-  iter->second.history_.clear();
-  iter->second.is_evictable_ = false;
+  RemoveLocked(node, frame_id);
+}
+
+auto LRUKReplacer::TryRemove(frame_id_t frame_id) -> bool {
+  if (frame_id < 0 || frame_id >= static_cast<frame_id_t>(replacer_size_)) {
+    return false;
+  }
+  DrainAccessQueues();
+  std::scoped_lock lock(latch_);
+  auto &node = node_store_[frame_id];
+  if (!node.is_evictable_) {
+    return false;
+  }
+  RemoveLocked(node, frame_id);
+  return true;
+}
+
+void LRUKReplacer::RemoveLocked(LRUKNode &node, frame_id_t frame_id) {
+  node.last_access_ = 0;
+  node.history_len_ = 0;
+  node.is_evictable_ = false;
   --curr_size_;
+  RefreshKey(frame_id);
 }
 
-auto LRUKReplacer::Size() -> size_t { return curr_size_; }
+auto LRUKReplacer::Size() -> size_t {
+  std::scoped_lock lock(latch_);
+  return curr_size_;
+}
 
 }  // namespace bustub
@@ -12,13 +12,16 @@
 
 #pragma once
 
-#include <list>
+#include <condition_variable>  // NOLINT
 #include <memory>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "buffer/lru_k_replacer.h"
+#include "buffer/page_table.h"
 #include "common/config.h"
+#include "common/spinlatch.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -121,6 +124,14 @@ class BufferPoolManager {
   auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
   auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
 
+  /**
+   * @brief Hint that page_id will be fetched soon. Pulls the page-table cache line for it in
+   * so the upcoming FetchPage finds the lookup structures warm; takes no latch and pins nothing.
+   *
+   * @param page_id the id of the page about to be fetched
+   */
+  void PrefetchPage(page_id_t page_id);
+
   /**
    * TODO(P1): Add implementation
    *
@@ -173,26 +184,227 @@ class BufferPoolManager {
   auto DeletePage(page_id_t page_id) -> bool;
 
  private:
+  /**
+   * A partition of the page table. Each partition owns a slice of the page_id -> frame_id
+   * mappings and a latch protecting them (plus the metadata of the pages currently mapped
+   * here). Entry points only contend when they touch the same partition, instead of
+   * serializing on one global latch.
+   */
+  struct Partition {
+    explicit Partition(size_t pool_size) : table_(pool_size) {}
+    /** If accessing table_ or the metadata of a page mapped here, you should fetch latch_ first.
+     * A spin latch: the critical sections are a few table probes and counter updates, far below
+     * the cost of a futex round trip, and nothing may block while holding it (flush-ring waits
+     * and disk I/O happen outside, see EvictFrame / FlushAllPages). */
+    SpinLatch latch_;
+    /** The page table slice holding the mappings of this partition. */
+    PageTable table_;
+  };
+
+  /**
+   * Treiber-style lock-free stack of free frame ids. Frame ids are dense, so frames are
+   * linked through a preallocated next_ array instead of heap-allocated list nodes, and
+   * head_ packs the top index with a version tag to defeat ABA. Push and Pop are one CAS
+   * each, so free-frame acquisition never takes a latch.
+   */
+  class FreeFrameStack {
+   public:
+    explicit FreeFrameStack(size_t pool_size) : next_(pool_size) {}
+
+    /** @brief Push a free frame onto the stack. */
+    void Push(frame_id_t frame_id) {
+      uint64_t head = head_.load(std::memory_order_relaxed);
+      for (;;) {
+        next_[frame_id].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        uint64_t desired = Pack(static_cast<uint32_t>(frame_id), Tag(head) + 1);
+        if (head_.compare_exchange_weak(head, desired, std::memory_order_release, std::memory_order_relaxed)) {
+          return;
+        }
+      }
+    }
+
+    /** @brief Pop a free frame. Returns false if the stack is empty. */
+    auto Pop(frame_id_t *frame_id) -> bool {
+      uint64_t head = head_.load(std::memory_order_acquire);
+      for (;;) {
+        uint32_t top = Index(head);
+        if (top == EMPTY) {
+          return false;
+        }
+        uint64_t desired = Pack(next_[top].load(std::memory_order_relaxed), Tag(head) + 1);
+        if (head_.compare_exchange_weak(head, desired, std::memory_order_acquire, std::memory_order_acquire)) {
+          *frame_id = static_cast<frame_id_t>(top);
+          return true;
+        }
+      }
+    }
+
+   private:
+    static constexpr uint32_t EMPTY = 0xFFFFFFFF;
+
+    static auto Pack(uint32_t index, uint32_t tag) -> uint64_t {
+      return (static_cast<uint64_t>(tag) << 32) | index;
+    }
+    static auto Index(uint64_t head) -> uint32_t { return static_cast<uint32_t>(head); }
+    static auto Tag(uint64_t head) -> uint32_t { return static_cast<uint32_t>(head >> 32); }
+
+    /** Top of stack: (tag << 32) | frame index, EMPTY index when the stack is empty. */
+    std::atomic<uint64_t> head_{Pack(EMPTY, 0)};
+    /** next_[i] is the frame below frame i on the stack (an EMPTY-terminated chain). */
+    std::vector<std::atomic<uint32_t>> next_;
+  };
+
+  /**
+   * A dirty eviction victim staged for write-back. Evictions copy the victim into a slot and
+   * hand the frame out immediately; the flusher thread drains slots to disk in the background,
+   * so a burst of evictions pays one 4KB copy each instead of one synchronous write each.
+   * A slot whose page_id_ is INVALID_PAGE_ID has been cancelled (the page was re-fetched).
+   */
+  struct FlushSlot {
+    page_id_t page_id_{INVALID_PAGE_ID};
+    std::unique_ptr<char[]> data_;
+  };
+
+  /** Maximum number of eviction writes parked in the flush ring. */
+  static constexpr size_t FLUSH_RING_CAPACITY = 64;
+
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
   /** The next page id to be allocated  */
   std::atomic<page_id_t> next_page_id_ = 0;
+  /** How many page ids AllocatePage reserves per thread in one RMW on next_page_id_, so
+   * allocation-heavy paths (page splits) stop rendezvousing on the shared counter. */
+  static constexpr page_id_t ID_ALLOC_BATCH = 16;
+  /** Identity token for this instance, handed to the per-thread id caches in AllocatePage so
+   * a cache reserved against a destroyed pool is never drained by its successor. */
+  const uint64_t instance_id_;
 
-  /** Array of buffer pool pages. */
+  /** Array of buffer pool pages. Holds the metadata only; the data of frame i lives at
+   * page_data_ + i * BUSTUB_PAGE_SIZE, so metadata walks never drag page bytes into cache. */
   Page *pages_;
+  /** One contiguous, page-aligned slab backing the data of every frame. */
+  char *page_data_{nullptr};
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
-  /** Replacer to find unpinned pages for replacement. */
+  /** Page table partitions; page_id lives in partitions_[page_id % BPM_PARTITIONS]. */
+  std::vector<std::unique_ptr<Partition>> partitions_;
+  /** Stack of free frames that don't have any pages on them. */
+  FreeFrameStack free_frames_;
+  /** Number of threads holding a frame privately or probing for one: raised before a thread
+   * tries the free stack or the replacer and kept raised until an acquired frame is republished
+   * (mapped or pushed back). While this is non-zero an empty replacer does not mean the pool is
+   * exhausted, it means frames are in transit and AcquireFrame should wait instead of failing. */
+  std::atomic<size_t> frames_in_transit_{0};
+  /** Replacer to find unpinned pages for replacement. Internally synchronized; its latch may be
+   * taken while a partition latch is held, never the other way around. */
   std::unique_ptr<LRUKReplacer> replacer_;
-  /** List of free frames that don't have any pages on them. */
-  std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
-  /** If accessing page_table_, replacer, free_list, you should fetch latch first. */
-  std::mutex latch_;
+
+  /** Ring of staged eviction writes, drained in FIFO order by flusher_thread_. */
+  std::vector<FlushSlot> flush_ring_;
+  /** Index of the next slot the flusher drains. */
+  size_t flush_head_{0};
+  /** Number of staged entries currently in the ring. */
+  size_t flush_size_{0};
+  /** Pages in the batch currently being written to disk by the flusher, empty if none. */
+  std::vector<page_id_t> inflight_pids_;
+  /** Total entries ever staged into the ring; paired with flushed_seq_ so a drain can wait
+   * for exactly the writes staged before it started instead of an ever-moving empty ring. */
+  size_t stage_seq_{0};
+  /** Total staged entries the flusher has fully retired (written or found cancelled). */
+  size_t flushed_seq_{0};
+  /** Set in the destructor to stop flusher_thread_ once the ring is drained. */
+  bool flush_shutdown_{false};
+  /** If accessing the flush ring state above, you should fetch flush_latch_ first. */
+  std::mutex flush_latch_;
+  /** Signalled on any flush ring state change (staged work, freed slot, finished write). */
+  std::condition_variable flush_cv_;
+  /** Background thread draining the flush ring. */
+  std::thread flusher_thread_;
+
+  /** Protects sleeping on io_cv_; loads flip Page::io_in_progress_ under it when finishing. */
+  std::mutex io_latch_;
+  /** Signalled whenever an in-progress page load completes. */
+  std::condition_variable io_cv_;
+
+  /** Number of public buffer pool calls currently executing, see ApiCallScope. */
+  std::atomic<size_t> active_calls_{0};
+
+  /** RAII marker for a public buffer pool call. The destructor of the last concurrent call
+   * drains the flush ring: an idle pool must have no background disk writes in flight, because
+   * callers historically may tear down the disk manager as soon as their last call returns
+   * (the synchronous-write buffer pool this one replaced made that safe). */
+  struct ApiCallScope {
+    explicit ApiCallScope(BufferPoolManager *bpm) : bpm_(bpm) {
+      bpm_->active_calls_.fetch_add(1, std::memory_order_acquire);
+    }
+    ~ApiCallScope() {
+      if (bpm_->active_calls_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        bpm_->DrainIfPending();
+      }
+    }
+    BufferPoolManager *bpm_;
+  };
+
+  /** @brief Return the partition responsible for page_id. */
+  auto PartitionOf(page_id_t page_id) -> Partition & {
+    return *partitions_[static_cast<size_t>(page_id) % BPM_PARTITIONS];
+  }
+
+  /**
+   * @brief Acquire a frame for a new mapping, from the free stack first and eviction second.
+   * Both sources being momentarily empty only proves exhaustion when no frame is in transit
+   * between threads, so in that case this waits for the transits to resolve and retries.
+   * Returns false only when every frame is resident and pinned. The caller owns the returned
+   * frame exclusively and must republish it (or release it) to balance frames_in_transit_.
+   */
+  auto AcquireFrame(frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Evict a victim frame through the replacer, unmap its old page and flush it if dirty.
+   * On success the caller exclusively owns the frame. Returns false if nothing is evictable.
+   */
+  auto EvictFrame(frame_id_t *frame_id) -> bool;
+
+  /** @brief Reset a spare frame and push it back onto the free frame stack. */
+  void ReleaseFrame(frame_id_t frame_id);
+
+  /** @brief Park a dirty victim in the flush ring. Fails instead of waiting when the ring is
+   * full, so it is safe to call under a partition spin latch; pair with WaitForFlushSpace. */
+  auto TryStageEvictionWrite(page_id_t page_id, const char *data) -> bool;
+
+  /** @brief Block until the flush ring has a free slot. Must not be called under a spin latch. */
+  void WaitForFlushSpace();
+
+  /**
+   * @brief Reclaim a staged copy of page_id, if one exists, instead of reading from disk.
+   * The staged entry is cancelled; the caller must mark the page dirty because the reclaimed
+   * copy never reached disk. Waits out an in-flight write of page_id so a subsequent disk
+   * read cannot observe stale bytes.
+   */
+  auto TryReadStaged(page_id_t page_id, char *data) -> bool;
+
+  /** @brief Cancel staged entries of page_id and wait out an in-flight write, so a direct
+   * WritePage of newer data cannot be clobbered by an older staged copy. */
+  void CancelStaged(page_id_t page_id);
+
+  /** @brief Block until the flush ring is empty and no write is in flight. */
+  void DrainFlushRing();
+
+  /** @brief Block until every write staged before this call has been retired. Unlike
+   * DrainFlushRing this does not wait out entries staged by calls that start afterwards, so
+   * the last exiting ApiCallScope cannot stall behind unrelated new traffic. */
+  void DrainIfPending();
+
+  /** @brief Background loop draining the flush ring to the disk manager. */
+  void FlusherLoop();
+
+  /** @brief Block until page's in-flight disk load (if any) has completed. */
+  void WaitForLoad(Page *page);
+
+  /** @brief Mark page's disk load complete and wake any waiting fetchers. */
+  void FinishLoad(Page *page);
 
   /**
    * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
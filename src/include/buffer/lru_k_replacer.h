@@ -12,10 +12,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <limits>
-#include <list>
+#include <memory>
 #include <mutex>  // NOLINT
-#include <unordered_map>
 #include <vector>
 
 #include "common/config.h"
@@ -27,10 +27,12 @@ enum class AccessType { Unknown = 0, Get, Scan };
 
 class LRUKNode {
  public:
-  /** History of last seen K timestamps of this page. Least recent timestamp stored in front. */
-  // Remove maybe_unused if you start using them. Feel free to change the member variables as you want.
-
-  std::list<size_t> history_;
+  /** Timestamp of the most recent access, the sort key for victim selection. 0 if untracked. */
+  size_t last_access_{0};
+  /** Number of recorded accesses, saturating at the replacer's k. Only the comparison against k
+   * (full history vs +inf backward k-distance) ever consults it, so the k timestamps themselves
+   * are not kept around. */
+  size_t history_len_{0};
   bool is_evictable_{false};
 };
 
@@ -44,6 +46,13 @@ class LRUKNode {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multiple frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * The replacer synchronizes itself through its internal latch. Accesses are additionally
+ * batched BP-Wrapper style: RecordAccess appends to one of a fixed set of small per-thread
+ * queues and returns, and a whole batch is replayed under the latch when a queue fills up or
+ * before a victim is chosen, so the hot path takes the latch once per batch rather than once
+ * per access. Queued accesses are guaranteed to be applied before the next Evict / Remove
+ * decision, so victim selection is unchanged for a single thread.
  */
 class LRUKReplacer {
  public:
@@ -136,6 +145,18 @@ class LRUKReplacer {
    */
   void Remove(frame_id_t frame_id);
 
+  /**
+   * @brief Try to remove a frame from the replacer, along with its access history.
+   *
+   * Unlike Remove, a frame that is not tracked or not evictable is not an error: the call
+   * simply fails. The buffer pool manager uses this to claim a frame for deletion; a false
+   * return means a concurrent eviction already claimed the frame.
+   *
+   * @param frame_id id of frame to be removed
+   * @return true if the frame was tracked, evictable and has been removed
+   */
+  auto TryRemove(frame_id_t frame_id) -> bool;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -146,14 +167,65 @@ class LRUKReplacer {
   auto Size() -> size_t;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
-  std::unordered_map<frame_id_t, LRUKNode> node_store_;
+  /** A queue of not-yet-applied accesses, shared by the threads hashing to it. */
+  struct AccessQueue {
+    std::mutex latch_;
+    std::vector<frame_id_t> pending_;
+  };
+
+  /** Number of access queues; threads pick one by hashing their id. */
+  static constexpr size_t ACCESS_QUEUE_COUNT = 32;
+  /** Queue length that triggers a batch flush into the replacer. */
+  static constexpr size_t ACCESS_BATCH_SIZE = 64;
+
+  /** @brief Replay every queued access into the replacer. Callers must not hold latch_. */
+  void DrainAccessQueues();
+
+  /** @brief Apply a batch of accesses, taking latch_ once for the whole batch. */
+  void ApplyBatch(std::vector<frame_id_t> &batch);
+
+  /** Packed eviction key of a frame that cannot be chosen as a victim. */
+  static constexpr uint64_t NOT_EVICTABLE = std::numeric_limits<uint64_t>::max();
+  /** Set in the packed key of frames with a full k_-deep history, so every +inf-distance frame
+   * compares below every full one and a single unsigned min over evict_key_ picks the victim. */
+  static constexpr uint64_t FULL_HISTORY_BIT = uint64_t{1} << 63U;
+
+  /** @brief Record one access. Caller holds latch_. */
+  void RecordAccessLocked(frame_id_t frame_id);
+
+  /** @brief Clear a node and mark its frame non-evictable. Caller holds latch_. */
+  void RemoveLocked(LRUKNode &node, frame_id_t frame_id);
+
+  /** @brief Recompute evict_key_ for a frame from its node. Caller holds latch_. */
+  void RefreshKey(frame_id_t frame_id) {
+    auto &node = node_store_[frame_id];
+    evict_key_[frame_id] = node.is_evictable_
+                               ? (node.last_access_ | (node.history_len_ < k_ ? 0 : FULL_HISTORY_BIT))
+                               : NOT_EVICTABLE;
+  }
+
+  /** @brief Frame with the smallest packed eviction key, or -1 if nothing is evictable.
+   * Ties resolve to the smallest frame id. Caller holds latch_. */
+  auto FindVictim() -> frame_id_t;
+
+  /** Per-frame state, indexed directly by frame id: frame ids are dense in [0, replacer_size_),
+   * so a flat array replaces the hash map — no hashing, no probing, and batched accesses can
+   * prefetch their nodes by index. A default-constructed node doubles as "not tracked yet". */
+  std::vector<LRUKNode> node_store_;
+  /** Packed per-frame eviction keys: timestamp of the last access, FULL_HISTORY_BIT once the
+   * history is k_ deep, NOT_EVICTABLE while the frame is pinned or untracked. Evict takes an
+   * unsigned min over this flat array (vectorized under AVX2); keeping the scan contiguous is
+   * what lets RecordAccess stay O(1) instead of maintaining ordered queues. Padded to a multiple
+   * of four entries with NOT_EVICTABLE so the vector loop needs no tail handling. */
+  std::vector<uint64_t> evict_key_;
+  /** Pending access batches, drained before any eviction decision. */
+  std::vector<std::unique_ptr<AccessQueue>> access_queues_;
   size_t current_timestamp_{0};
   size_t curr_size_{0};
   size_t replacer_size_;
   size_t k_;
-  [[maybe_unused]] std::mutex latch_;
+  /** If accessing node_store_, the eviction queues or the counters, you should fetch latch_ first. */
+  std::mutex latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * PageTable is an open-addressed hash table mapping page_id_t -> frame_id_t,
+ * specialized for the buffer pool manager.
+ *
+ * The table is a single contiguous array of 8-byte slots probed linearly with
+ * Robin Hood displacement, so a lookup usually touches exactly one cache line
+ * instead of chasing std::unordered_map bucket nodes. Capacity is fixed at the
+ * next power of two >= 2 * pool_size: the buffer pool can never hold more than
+ * pool_size mappings, so the load factor stays below 0.5 and the table never
+ * needs to grow.
+ *
+ * The table is not thread safe; callers synchronize through the buffer pool
+ * manager's latch, exactly as with the std::unordered_map it replaces.
+ */
+class PageTable {
+ public:
+  explicit PageTable(size_t pool_size) {
+    size_t capacity = 16;
+    while (capacity < 2 * pool_size) {
+      capacity <<= 1;
+    }
+    mask_ = static_cast<uint32_t>(capacity - 1);
+    slots_.resize(capacity);
+  }
+
+  /** @brief Look up the frame holding page_id. Returns false if the page is not mapped. */
+  auto Find(page_id_t page_id, frame_id_t *frame_id) const -> bool {
+    for (uint32_t idx = Hash(page_id);; idx = (idx + 1) & mask_) {
+      const auto &slot = slots_[idx];
+      if (slot.key_ == page_id) {
+        *frame_id = slot.val_;
+        return true;
+      }
+      if (slot.key_ == INVALID_PAGE_ID) {
+        return false;
+      }
+    }
+  }
+
+  /** @brief Map page_id to frame_id, overwriting any existing mapping. */
+  void Insert(page_id_t page_id, frame_id_t frame_id) {
+    Slot probe{page_id, frame_id};
+    uint32_t dist = 0;
+    for (uint32_t idx = Hash(page_id);; idx = (idx + 1) & mask_, ++dist) {
+      auto &slot = slots_[idx];
+      if (slot.key_ == probe.key_) {
+        slot.val_ = probe.val_;
+        return;
+      }
+      if (slot.key_ == INVALID_PAGE_ID) {
+        slot = probe;
+        return;
+      }
+      // Robin Hood: displace a resident slot that is closer to its home than
+      // the probing entry, keeping probe sequences short for every key.
+      if (ProbeDistance(slot.key_, idx) < dist) {
+        std::swap(slot, probe);
+        dist = ProbeDistance(probe.key_, idx);
+      }
+    }
+  }
+
+  /** @brief Remove the mapping for page_id. Returns false if the page is not mapped. */
+  auto Erase(page_id_t page_id) -> bool {
+    for (uint32_t idx = Hash(page_id);; idx = (idx + 1) & mask_) {
+      if (slots_[idx].key_ == INVALID_PAGE_ID) {
+        return false;
+      }
+      if (slots_[idx].key_ != page_id) {
+        continue;
+      }
+      // Backward-shift deletion: pull displaced successors one slot closer to
+      // their home so no tombstones are needed.
+      uint32_t hole = idx;
+      for (uint32_t next = (hole + 1) & mask_;; hole = next, next = (next + 1) & mask_) {
+        if (slots_[next].key_ == INVALID_PAGE_ID || ProbeDistance(slots_[next].key_, next) == 0) {
+          break;
+        }
+        slots_[hole] = slots_[next];
+      }
+      slots_[hole].key_ = INVALID_PAGE_ID;
+      return true;
+    }
+  }
+
+  /** @brief Hint the CPU to pull the home cache line of page_id into cache. */
+  void Prefetch(page_id_t page_id) const { __builtin_prefetch(&slots_[Hash(page_id)]); }
+
+ private:
+  struct Slot {
+    page_id_t key_{INVALID_PAGE_ID};
+    frame_id_t val_{0};
+  };
+  static_assert(sizeof(Slot) == 8, "slots should stay within a single cache line per probe");
+
+  /** @brief Finalizer-style integer hash (murmur3 fmix32) masked to the table size. */
+  auto Hash(page_id_t page_id) const -> uint32_t {
+    auto h = static_cast<uint32_t>(page_id);
+    h ^= h >> 16;
+    h *= 0x85EBCA6B;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35;
+    h ^= h >> 16;
+    return h & mask_;
+  }
+
+  /** @brief Distance of the slot at idx from the home slot of its key. */
+  auto ProbeDistance(page_id_t key, uint32_t idx) const -> uint32_t { return (idx - Hash(key)) & mask_; }
+
+  std::vector<Slot> slots_;
+  uint32_t mask_;
+};
+
+}  // namespace bustub
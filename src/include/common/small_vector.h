@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// small_vector.h
+//
+// Identification: src/include/common/small_vector.h
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace bustub {
+
+/**
+ * A sequence with inline storage for its first N elements, for small hot containers whose
+ * typical size is known up front (e.g. a latch-coupling write set bounded by the tree height).
+ * Nothing is heap-allocated until the inline capacity overflows; elements must be movable,
+ * and growth or PopFront relocates them, so references into the container do not survive
+ * mutation.
+ */
+template <typename T, size_t N>
+class SmallVector {
+ public:
+  SmallVector() = default;
+  SmallVector(const SmallVector &) = delete;
+  auto operator=(const SmallVector &) -> SmallVector & = delete;
+
+  ~SmallVector() {
+    Clear();
+    if (data_ != InlineData()) {
+      ::operator delete(data_, std::align_val_t(alignof(T)));
+    }
+  }
+
+  template <typename... Args>
+  auto EmplaceBack(Args &&...args) -> T & {
+    if (size_ == capacity_) {
+      Grow();
+    }
+    T *slot = data_ + size_;
+    new (slot) T(std::forward<Args>(args)...);
+    ++size_;
+    return *slot;
+  }
+
+  void PopBack() { data_[--size_].~T(); }
+
+  void PopFront() {
+    std::move(data_ + 1, data_ + size_, data_);
+    PopBack();
+  }
+
+  auto Back() -> T & { return data_[size_ - 1]; }
+
+  void Clear() {
+    while (size_ > 0) {
+      PopBack();
+    }
+  }
+
+  auto Size() const -> size_t { return size_; }
+
+  auto Empty() const -> bool { return size_ == 0; }
+
+  auto begin() -> T * { return data_; }
+  auto end() -> T * { return data_ + size_; }
+
+ private:
+  auto InlineData() -> T * { return reinterpret_cast<T *>(inline_); }
+
+  void Grow() {
+    const size_t new_capacity = capacity_ * 2;
+    T *new_data = static_cast<T *>(::operator new(new_capacity * sizeof(T), std::align_val_t(alignof(T))));
+    for (size_t i = 0; i < size_; ++i) {
+      new (new_data + i) T(std::move(data_[i]));
+      data_[i].~T();
+    }
+    if (data_ != InlineData()) {
+      ::operator delete(data_, std::align_val_t(alignof(T)));
+    }
+    data_ = new_data;
+    capacity_ = new_capacity;
+  }
+
+  alignas(T) unsigned char inline_[N * sizeof(T)];
+  T *data_{reinterpret_cast<T *>(inline_)};
+  size_t size_{0};
+  size_t capacity_{N};
+};
+
+}  // namespace bustub
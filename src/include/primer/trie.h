@@ -2,8 +2,8 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <future>  // NOLINT
-#include <map>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -12,6 +12,10 @@
 #include <utility>
 #include <vector>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 namespace bustub {
 
 /// A special type that will block the move constructor and move assignment operator. Used in TrieStore tests.
@@ -40,6 +44,104 @@ class MoveBlocked {
   std::future<int> wait_;
 };
 
+class TrieNode;
+
+// Tag identifying the value type stored in a TrieNodeWithValue<T>, with 0 meaning "no tag".
+// One specialization exists per type the trie is explicitly instantiated with (see the bottom
+// of trie.cpp); Get compares tags with a single branch instead of dynamic_cast-ing, avoiding
+// the RTTI walk on every hit. Untagged types keep the dynamic_cast fallback.
+template <class T>
+inline constexpr uint8_t TYPE_TAG = 0;
+template <>
+inline constexpr uint8_t TYPE_TAG<uint32_t> = 1;
+template <>
+inline constexpr uint8_t TYPE_TAG<uint64_t> = 2;
+template <>
+inline constexpr uint8_t TYPE_TAG<std::string> = 3;
+template <>
+inline constexpr uint8_t TYPE_TAG<std::unique_ptr<uint32_t>> = 4;
+template <>
+inline constexpr uint8_t TYPE_TAG<MoveBlocked> = 5;
+
+// The children of a TrieNode. Instead of a std::map (one heap node per child, a branchy tree walk
+// per lookup), keys and child pointers live in two parallel flat arrays: locating a child is a
+// SIMD compare over the key bytes, and cloning a node is a plain vector copy. The key array is
+// padded to a multiple of 16 bytes so the scan always compares whole 16-byte chunks; lanes at or
+// beyond Size() are masked out of the match.
+class TrieChildren {
+ public:
+  // Position meaning "no child with that key". Positions returned by FindIndex stay valid across
+  // Clone, so a caller can scan a node once and reuse the position on the clone.
+  static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+  // Returns a pointer to the child for `c`, or nullptr if there is none.
+  auto Find(char c) const -> const std::shared_ptr<const TrieNode> * {
+    auto idx = FindIndex(c);
+    return idx == NPOS ? nullptr : &children_[idx];
+  }
+
+  // Appends a child for `c`. The caller must know `c` is absent (e.g. FindIndex returned NPOS).
+  void Append(char c, std::shared_ptr<const TrieNode> child) {
+    if (children_.size() == keys_.size()) {
+      keys_.resize(keys_.size() + CHUNK);  // padding; never part of a match
+    }
+    keys_[children_.size()] = static_cast<uint8_t>(c);
+    children_.push_back(std::move(child));
+  }
+
+  // Overwrites the child at position i, keeping its key.
+  void SetAt(size_t i, std::shared_ptr<const TrieNode> child) { children_[i] = std::move(child); }
+
+  // Removes the child at position i. The last child takes its slot, so children are unordered.
+  void EraseAt(size_t i) {
+    keys_[i] = keys_[children_.size() - 1];
+    children_[i] = std::move(children_.back());
+    children_.pop_back();
+  }
+
+  auto Empty() const -> bool { return children_.empty(); }
+
+  auto Size() const -> size_t { return children_.size(); }
+
+  // Key and child at position i (0 <= i < Size()). Children are unordered.
+  auto KeyAt(size_t i) const -> char { return static_cast<char>(keys_[i]); }
+
+  auto ChildAt(size_t i) const -> const std::shared_ptr<const TrieNode> & { return children_[i]; }
+
+  // Returns the position of the child for `c`, or NPOS if there is none.
+  auto FindIndex(char c) const -> size_t {
+    const size_t n = children_.size();
+#ifdef __SSE2__
+    const __m128i needle = _mm_set1_epi8(c);
+    for (size_t i = 0; i < n; i += CHUNK) {
+      auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys_.data() + i));
+      auto m = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+      if (n - i < CHUNK) {
+        m &= (1U << (n - i)) - 1;  // drop the padding lanes
+      }
+      if (m != 0) {
+        return i + static_cast<size_t>(__builtin_ctz(m));
+      }
+    }
+#else
+    for (size_t i = 0; i < n; i++) {
+      if (keys_[i] == static_cast<uint8_t>(c)) {
+        return i;
+      }
+    }
+#endif
+    return NPOS;
+  }
+
+ private:
+  static constexpr size_t CHUNK = 16;
+
+  // Key bytes; entry i is the key of children_[i]. Padded to a multiple of CHUNK bytes.
+  std::vector<uint8_t> keys_;
+  // Child pointers, parallel to keys_.
+  std::vector<std::shared_ptr<const TrieNode>> children_;
+};
+
 // A TrieNode is a node in a Trie.
 class TrieNode {
  public:
@@ -47,7 +149,7 @@ class TrieNode {
   TrieNode() = default;
 
   // Create a TrieNode with some children.
-  explicit TrieNode(std::map<char, std::shared_ptr<const TrieNode>> children) : children_(std::move(children)) {}
+  explicit TrieNode(TrieChildren children) : children_(std::move(children)) {}
 
   virtual ~TrieNode() = default;
 
@@ -58,14 +160,26 @@ class TrieNode {
   // contains a value or not.
   //
   // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
-  virtual auto Clone() const -> std::unique_ptr<TrieNode> { return std::make_unique<TrieNode>(children_); }
+  virtual auto Clone() const -> std::unique_ptr<TrieNode> {
+    auto node = std::make_unique<TrieNode>(children_);
+    node->prefix_ = prefix_;
+    return node;
+  }
+
+  // The children of this node, keyed by the next character in the key.
+  TrieChildren children_;
 
-  // A map of children, where the key is the next character in the key, and the value is the next TrieNode.
-  std::map<char, std::shared_ptr<const TrieNode>> children_;
+  // Collapsed path bytes between the parent's edge character and this node's children
+  // (patricia-style compression): the full edge from the parent is <edge char> + prefix_.
+  // Key characters with no branch point and no value collapse into one node instead of a chain.
+  std::string prefix_;
 
   // Indicates if the node is the terminal node.
   bool is_value_node_{false};
 
+  // TYPE_TAG of the stored value's type, 0 for a plain node or an untagged type.
+  uint8_t type_tag_{0};
+
   // You can add additional fields and methods here. But in general, you don't need to add extra fields to
   // complete this project.
 };
@@ -75,19 +189,25 @@ template <class T>
 class TrieNodeWithValue : public TrieNode {
  public:
   // Create a trie node with no children and a value.
-  explicit TrieNodeWithValue(std::shared_ptr<T> value) : value_(std::move(value)) { this->is_value_node_ = true; }
+  explicit TrieNodeWithValue(std::shared_ptr<T> value) : value_(std::move(value)) {
+    this->is_value_node_ = true;
+    this->type_tag_ = TYPE_TAG<T>;
+  }
 
   // Create a trie node with children and a value.
-  TrieNodeWithValue(std::map<char, std::shared_ptr<const TrieNode>> children, std::shared_ptr<T> value)
+  TrieNodeWithValue(TrieChildren children, std::shared_ptr<T> value)
       : TrieNode(std::move(children)), value_(std::move(value)) {
     this->is_value_node_ = true;
+    this->type_tag_ = TYPE_TAG<T>;
   }
 
   // Override the Clone method to also clone the value.
   //
   // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
   auto Clone() const -> std::unique_ptr<TrieNode> override {
-    return std::make_unique<TrieNodeWithValue<T>>(children_, value_);
+    auto node = std::make_unique<TrieNodeWithValue<T>>(children_, value_);
+    node->prefix_ = prefix_;
+    return node;
   }
 
   // The value associated with this trie node.
@@ -98,6 +218,9 @@ class TrieNodeWithValue : public TrieNode {
 // modify the trie itself. It should reuse the existing nodes as much as possible, and create new nodes to
 // represent the new trie.
 class Trie {
+  // TrieStore publishes and protects raw root pointers, so it needs access to root_.
+  friend class TrieStore;
+
  private:
   // The root of the trie.
   std::shared_ptr<const TrieNode> root_{nullptr};
@@ -1,29 +1,73 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <mutex>  // NOLINT
 #include <optional>
-#include <shared_mutex>
 #include <utility>
+#include <vector>
 
 #include "primer/trie.h"
 
 namespace bustub {
 
-// This class is used to guard the value returned by the trie. It holds a reference to the root so
-// that the reference to the value will not be invalidated.
+// This class is used to guard the value returned by the trie. While it is alive it keeps the trie
+// version the value lives in from being reclaimed: on the fast path it occupies a hazard slot of
+// the TrieStore, on the fallback path it owns a reference to the root.
 template <class T>
 class ValueGuard {
  public:
-  ValueGuard(Trie root, const T &value) : root_(std::move(root)), value_(value) {}
-  auto operator*() const -> const T & { return value_; }
+  // Owning snapshot: the guard holds the trie version itself.
+  ValueGuard(Trie root, const T &value) : root_(std::move(root)), value_(&value) {}
+
+  // Hazard mode: the slot already protects the version; the guard clears it on destruction.
+  ValueGuard(std::atomic<const TrieNode *> *hazard_slot, const T &value) : hazard_slot_(hazard_slot), value_(&value) {}
+
+  ValueGuard(const ValueGuard &) = delete;
+  auto operator=(const ValueGuard &) -> ValueGuard & = delete;
+
+  ValueGuard(ValueGuard &&that) noexcept
+      : root_(std::move(that.root_)), hazard_slot_(that.hazard_slot_), value_(that.value_) {
+    that.hazard_slot_ = nullptr;
+  }
+
+  auto operator=(ValueGuard &&that) noexcept -> ValueGuard & {
+    if (this != &that) {
+      Release();
+      root_ = std::move(that.root_);
+      hazard_slot_ = that.hazard_slot_;
+      value_ = that.value_;
+      that.hazard_slot_ = nullptr;
+    }
+    return *this;
+  }
+
+  ~ValueGuard() { Release(); }
+
+  auto operator*() const -> const T & { return *value_; }
 
  private:
+  void Release() {
+    if (hazard_slot_ != nullptr) {
+      hazard_slot_->store(nullptr);
+      hazard_slot_ = nullptr;
+    }
+  }
+
   Trie root_;
-  const T &value_;
+  std::atomic<const TrieNode *> *hazard_slot_{nullptr};
+  const T *value_;
 };
 
 // This class is a thread-safe wrapper around the Trie class. It provides a simple interface for
-// accessing the trie. It should allow concurrent reads and a single write operation at the same
-// time.
+// accessing the trie. It allows concurrent reads and a single write operation at the same time.
+//
+// A reader does not bump any shared reference count (an atomic RMW whose cache line would bounce
+// between reader cores): it loads the current root pointer, publishes it in a hazard slot and
+// re-checks the root, which pins that version for as long as the slot is held. A writer installs
+// a new version with an atomic store and moves the old one onto a retired list; a retired version
+// is only dropped once no hazard slot points at its root. Guards returned by Get occupy their
+// slot until destroyed, so they must not outlive the store.
 class TrieStore {
  public:
   // This function returns a ValueGuard object that holds a reference to the value in the trie. If
@@ -40,15 +84,38 @@ class TrieStore {
   void Remove(std::string_view key);
 
  private:
-  // This mutex protects the root. Every time you want to access the trie root or modify it, you
-  // will need to take this lock.
+  // Number of hazard slots, which bounds the number of concurrently live fast-path guards.
+  static constexpr size_t HAZARD_SLOTS = 64;
+
+  // Claim a free hazard slot and publish `root` in it. Returns nullptr when every slot is busy.
+  auto TryProtect(const TrieNode *root) -> std::atomic<const TrieNode *> *;
+
+  // Install `new_root` as the current version and retire the previous one. Caller holds
+  // write_lock_.
+  void PublishVersion(Trie new_root);
+
+  // Drop every retired version whose root no longer sits in a hazard slot. Caller holds
+  // write_lock_.
+  void ScanRetired();
+
+  // Raw root of the current version; what readers start from.
+  std::atomic<const TrieNode *> root_ptr_{nullptr};
+
+  // Slots in which readers mark the version they are traversing.
+  std::array<std::atomic<const TrieNode *>, HAZARD_SLOTS> hazard_slots_{};
+
+  // This mutex protects the root handle below. Fallback readers copy it when no hazard slot is
+  // free; the writer updates it when publishing a version.
   std::mutex root_lock_;
 
   // This mutex sequences all writes operations and allows only one write operation at a time.
   std::mutex write_lock_;
 
-  // Stores the current root for the trie.
+  // Owns the current version of the trie.
   Trie root_;
+
+  // Old versions that may still be read through a hazard slot. Only the writer touches this.
+  std::vector<Trie> retired_;
 };
 
 }  // namespace bustub
@@ -51,6 +51,16 @@ class DiskManager {
    */
   virtual void WritePage(page_id_t page_id, const char *page_data);
 
+  /**
+   * Write a run of consecutive pages to the database file in one file operation.
+   * The default implementation issues a single seek and one contiguous write, which
+   * is what the buffer pool's flusher relies on to amortize per-write overhead.
+   * @param first_page_id id of the first page in the run
+   * @param page_data num_pages pages of raw page data, laid out back to back
+   * @param num_pages length of the run
+   */
+  virtual void WritePages(page_id_t first_page_id, const char *page_data, size_t num_pages);
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
@@ -46,6 +46,14 @@ class DiskManagerMemory : public DiskManager {
    */
   void WritePage(page_id_t page_id, const char *page_data) override;
 
+  /**
+   * Write a run of consecutive pages to the database file.
+   * @param first_page_id id of the first page in the run
+   * @param page_data num_pages pages of raw page data, laid out back to back
+   * @param num_pages length of the run
+   */
+  void WritePages(page_id_t first_page_id, const char *page_data, size_t num_pages) override;
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
@@ -89,6 +97,19 @@ class DiskManagerUnlimitedMemory : public DiskManager {
     memcpy(ptr->first.data(), page_data, BUSTUB_PAGE_SIZE);
   }
 
+  /**
+   * Write a run of consecutive pages to the database file.
+   * @param first_page_id id of the first page in the run
+   * @param page_data num_pages pages of raw page data, laid out back to back
+   * @param num_pages length of the run
+   */
+  void WritePages(page_id_t first_page_id, const char *page_data, size_t num_pages) override {
+    // pages here are independently latched objects, so the run degenerates to per-page writes
+    for (size_t i = 0; i < num_pages; i++) {
+      WritePage(first_page_id + static_cast<page_id_t>(i), page_data + i * BUSTUB_PAGE_SIZE);
+    }
+  }
+
   /**
    * Read a page from the database file.
    * @param page_id id of the page
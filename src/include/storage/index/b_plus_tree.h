@@ -11,16 +11,19 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <deque>
 #include <iostream>
 #include <optional>
 #include <queue>
 #include <shared_mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "common/config.h"
 #include "common/macros.h"
+#include "common/small_vector.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_header_page.h"
@@ -47,8 +50,11 @@ class Context {
   // Save the root page id here so that it's easier to know if the current page is the root page.
   page_id_t root_page_id_{INVALID_PAGE_ID};
 
-  // Store the write guards of the pages that you're modifying here.
-  std::deque<WritePageGuard> write_set_;
+  // Store the write guards of the pages that you're modifying here, each paired with the
+  // slot index the descent took out of that page, so the ascent after a split can reuse it
+  // instead of re-running the key search on every level. Inline storage for eight levels
+  // covers any realistic tree height, so pushing guards never touches the heap.
+  SmallVector<std::pair<WritePageGuard, int>, 8> write_set_;
 
   // You may want to use this when getting value, but not necessary.
   std::deque<ReadPageGuard> read_set_;
@@ -155,6 +161,13 @@ class BPlusTree {
    */
   auto LeafKeyIndex(const LeafPage *leaf, const KeyType &key) const -> int;
 
+  /**
+   *
+   * @param key The key to insert
+   * @return i, the slot the key should be inserted at (k[i] == key if the key already exists)
+   */
+  auto LeafInsertIndex(const LeafPage *leaf, const KeyType &key) const -> int;
+
   /**
    * @param page page modified
    * @param isInsert is insert or delete
@@ -162,15 +175,56 @@ class BPlusTree {
    */
   auto IsSafeModify(const BPlusTreePage *page, bool isInsert) const -> bool;
 
+  /**
+   * One optimistic insert pass: descend on read latches and write-latch only the leaf, so
+   * concurrent inserts stop serializing on the root write latch.
+   * @return the insert outcome, or nullopt when this pass cannot decide (empty tree, leaf
+   * root, or a leaf that must split) and the caller has to redo the descent write-coupled
+   */
+  auto InsertOptimistic(const KeyType &key, const ValueType &value) -> std::optional<bool>;
+
+  /**
+   * One optimistic lookup pass: descend over internal nodes with pins and page version checks
+   * only, so point queries stop paying two latch RMWs per level; the leaf itself is still
+   * read-latched before its records are touched.
+   * @return the lookup outcome, or nullopt when a version check failed and the caller has to
+   * redo the descent with read latches
+   */
+  auto GetValueOptimistic(const KeyType &key, std::vector<ValueType> *result) -> std::optional<bool>;
+
+  /**
+   * Read-latch the current root through cached_root_ without touching the header page.
+   * @return a read guard on the root, or nullopt when the tree is empty
+   */
+  auto FetchRootRead() -> std::optional<ReadPageGuard>;
+
   void MoveLeafChild(LeafPage *fromPage, int fromPos, LeafPage *ToPage, int toPos, int size);
   void MoveInternalChild(InternalPage *fromPage, int fromPos, InternalPage *ToPage, int toPos, int size);
   void InsertIntoLeaf(LeafPage *leaf, int i, const KeyType &key, const ValueType &value);
   void InsertIntoInternal(InternalPage *internal, int i, const KeyType &key, const page_id_t value);
-  auto SplitLeaf(LeafPage *leaf) -> page_id_t;
+  auto SplitLeaf(LeafPage *leaf, BasicPageGuard &&spare) -> page_id_t;
   auto SplitInternal(InternalPage *internal) -> page_id_t;
 
+  /**
+   * Build an empty tree bottom-up from a batch of key-value pairs: sort, fill the leaf level
+   * sequentially linking next_page_id_, then emit one parent entry per node level by level.
+   * Every page is written exactly once, so loading costs one page per node instead of one
+   * descent per key, and no node ever splits.
+   * @return false when the tree is not empty and the caller must fall back to per-key Insert
+   */
+  auto BulkLoad(std::vector<std::pair<KeyType, ValueType>> &kvs) -> bool;
+
+  /** Node capacity from which key searches switch from the branchless linear scan to binary
+   * search; below it the linear scan wins because it has no hard-to-predict partition steps. */
+  static constexpr int BINARY_SEARCH_THRESHOLD = 16;
+
   // member variable
   std::string index_name_;
+  /** Replica of the header page's root_page_id_, so read paths stop pinning and read-latching
+   * the header page just to load one page id. A root change publishes the new id here before
+   * the old root's write latch is released; readers revalidate against it after latching the
+   * presumed root (see FetchRootRead), so a stale id can never be descended. */
+  std::atomic<page_id_t> cached_root_{INVALID_PAGE_ID};
   BufferPoolManager *bpm_;
   KeyComparator comparator_;
   std::vector<std::string> log;  // NOLINT
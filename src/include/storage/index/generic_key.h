@@ -77,6 +77,17 @@ template <size_t KeySize>
 class GenericComparator {
  public:
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
+    if constexpr (KeySize >= sizeof(int64_t)) {
+      if (single_bigint_) {
+        // the common index-key shape (one fixed BIGINT column at offset 0) is just the first
+        // 8 bytes of the key, so compare them directly instead of materializing two Values
+        int64_t l;
+        int64_t r;
+        memcpy(&l, lhs.data_, sizeof(int64_t));
+        memcpy(&r, rhs.data_, sizeof(int64_t));
+        return static_cast<int>(l > r) - static_cast<int>(l < r);
+      }
+    }
     uint32_t column_count = key_schema_->GetColumnCount();
 
     for (uint32_t i = 0; i < column_count; i++) {
@@ -94,13 +105,23 @@ class GenericComparator {
     return 0;
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  /** True when keys under this comparator are raw int64s (one inlined BIGINT at offset 0), so
+   * callers may compare the first 8 key bytes directly, e.g. with vector instructions. */
+  auto IsSingleBigint() const -> bool { return single_bigint_; }
+
+  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_}, single_bigint_{other.single_bigint_} {}
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  explicit GenericComparator(Schema *key_schema)
+      : key_schema_(key_schema),
+        single_bigint_(key_schema != nullptr && key_schema->GetColumnCount() == 1 &&
+                       key_schema->GetColumn(0).GetType() == TypeId::BIGINT && key_schema->GetColumn(0).GetOffset() == 0) {}
 
  private:
   Schema *key_schema_;
+  /** True when the schema is a single inlined BIGINT at offset 0, so compares can skip the
+   * per-column Value machinery; decided once here instead of per comparison. */
+  bool single_bigint_;
 };
 
 }  // namespace bustub
@@ -29,9 +29,12 @@ namespace bustub {
  * should ignore the first key.
  *
  * Internal page format (keys are stored in increasing order):
- *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
- *  --------------------------------------------------------------------------
+ *  ----------------------------------------------------------------------------------
+ * | HEADER | KEY(1) | KEY(2) | ... | KEY(max) | PAGE_ID(1) | PAGE_ID(2) | ... | PAGE_ID(max) |
+ *  ----------------------------------------------------------------------------------
+ * Keys and child ids live in two separate arrays rather than interleaved pairs: searches
+ * only touch keys, and packing them densely doubles the keys per cache line the search
+ * walks. The values array starts at a fixed offset of max_size keys.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
@@ -76,6 +79,11 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   // store value
   void SetValueAt(int index, const ValueType &value);
 
+  auto Keys() -> KeyType *;
+  auto Keys() const -> const KeyType *;
+  auto Values() -> ValueType *;
+  auto Values() const -> const ValueType *;
+
   /**
    * @brief For test only, return a string representing all keys in
    * this internal page, formatted as "(key1,key2,key3,...)"
@@ -103,7 +111,7 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   }
 
  private:
-  // Flexible array member for page data.
-  MappingType array_[0];
+  // Flexible array member for page data: max_size keys followed by max_size child ids.
+  char data_[0];
 };
 }  // namespace bustub
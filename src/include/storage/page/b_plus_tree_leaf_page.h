@@ -62,6 +62,7 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   void SetKeyAt(int index, const KeyType &key);
   void SetValueAt(int index, const ValueType &value);
   auto GetMapping(int index) const -> const MappingType &;
+  auto GetArray() -> MappingType *;
 
   /**
    * @brief for test only return a string representing all keys in
@@ -12,8 +12,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstring>
 #include <iostream>
+#include <new>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 #include "common/config.h"
 #include "common/rwlatch.h"
@@ -32,12 +38,16 @@ class Page {
  public:
   /** Constructor. Zeros out the page data. */
   Page() {
-    data_ = new char[BUSTUB_PAGE_SIZE];
+    data_ = static_cast<char *>(::operator new[](BUSTUB_PAGE_SIZE, std::align_val_t(DATA_ALIGNMENT)));
     ResetMemory();
   }
 
   /** Default destructor. */
-  ~Page() { delete[] data_; }
+  ~Page() {
+    if (owns_data_) {
+      ::operator delete[](data_, std::align_val_t(DATA_ALIGNMENT));
+    }
+  }
 
   /** @return the actual data contained within this page */
   inline auto GetData() -> char * { return data_; }
@@ -63,6 +73,15 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /** @return the page's structural version, for optimistic readers; odd while a writer is
+   * restructuring the page. */
+  inline auto ReadSeq() -> uint64_t { return seq_.load(std::memory_order_acquire); }
+
+  /** Advance the structural version. Writers call this once before restructuring (marking the
+   * page odd) and once after (even again); both sides of a seqlock-style read then detect the
+   * overlap. */
+  inline void BumpSeq() { seq_.fetch_add(1, std::memory_order_acq_rel); }
+
   /** @return the page LSN. */
   inline auto GetLSN() -> lsn_t { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -76,21 +95,61 @@ class Page {
   static constexpr size_t SIZE_PAGE_HEADER = 8;
   static constexpr size_t OFFSET_PAGE_START = 0;
   static constexpr size_t OFFSET_LSN = 4;
+  /** Cache-line alignment of data_, required for the non-temporal stores in ResetMemory. */
+  static constexpr size_t DATA_ALIGNMENT = 64;
 
  private:
-  /** Zeroes out the data that is held within the page. */
-  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE); }
+  /** Point this page at an externally owned, zeroed-on-entry buffer (the buffer pool's
+   * contiguous page-data slab). Frees the buffer the constructor allocated; the page no longer
+   * owns its data. Only the buffer pool manager calls this. */
+  void SetDataBuffer(char *data) {
+    if (owns_data_) {
+      ::operator delete[](data_, std::align_val_t(DATA_ALIGNMENT));
+    }
+    data_ = data;
+    owns_data_ = false;
+    ResetMemory();
+  }
+
+  /** Zeroes out the data that is held within the page. With AVX2 the zeros are written with
+   * non-temporal stores: a freshly cleared page is about to be overwritten (or read once) anyway,
+   * so pushing 4KB of zeros through L1/L2 would only evict hotter lines. */
+  inline void ResetMemory() {
+#ifdef __AVX2__
+    const __m256i zero = _mm256_setzero_si256();
+    for (size_t i = 0; i < BUSTUB_PAGE_SIZE; i += sizeof(__m256i)) {
+      _mm256_stream_si256(reinterpret_cast<__m256i *>(data_ + i), zero);
+    }
+    _mm_sfence();
+#else
+    memset(data_, OFFSET_PAGE_START, BUSTUB_PAGE_SIZE);
+#endif
+  }
 
   /** The actual data that is stored within a page. */
   // Usually this should be stored as `char data_[BUSTUB_PAGE_SIZE]{};`. But to enable ASAN to detect page overflow,
   // we store it as a ptr.
   char *data_;
+  /** False once the buffer pool pointed this page into its shared slab via SetDataBuffer. */
+  bool owns_data_ = true;
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  /** The pin count of this page. Atomic so the buffer pool manager can pin and unpin a resident
+   * page with a single RMW instead of serializing on a latch. */
+  std::atomic<int> pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_ = false;
+  /** True while the frame's data is still being loaded from disk; fetchers of the same page
+   * pin the frame and wait for the load instead of issuing a second read. */
+  std::atomic<bool> io_in_progress_ = false;
+  /** True while a thread that removed this frame from the replacer still owns the removal. A
+   * pin/unpin cycle can re-register the frame and let a second thread remove it again before
+   * the first claim resolves; whoever loses the CAS on this flag must abandon its claim. */
+  std::atomic<bool> evict_claim_ = false;
+  /** Structural version for seqlock-style optimistic readers (see ReadSeq/BumpSeq). Writers
+   * only bump it while holding both a pin and the write latch, so a frame is always even when
+   * it returns to the free list and the counter never leaks an odd value across page reuse. */
+  std::atomic<uint64_t> seq_ = 0;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
 };
@@ -73,6 +73,9 @@ class BasicPageGuard {
     return page_->GetData();
   }
 
+  /** @return the page's structural version, for seqlock-style optimistic reads */
+  auto Seq() const -> uint64_t { return page_->ReadSeq(); }
+
   template <class T>
   auto AsMut() -> T * {
     return reinterpret_cast<T *>(GetDataMut());
@@ -209,6 +212,10 @@ class WritePageGuard {
     return guard_.AsMut<T>();
   }
 
+  /** Advance the held page's structural version; call once before restructuring it and once
+   * after, so optimistic readers overlapping the change retry instead of using torn data. */
+  void BumpSeq() { guard_.page_->BumpSeq(); }
+
  private:
   // You may choose to get rid of this and add your own private variables.
   BasicPageGuard guard_;
@@ -1,10 +1,132 @@
 #include "primer/trie.h"
-#include <stack>
+#include <optional>
 #include <string_view>
 #include "common/exception.h"
 
 namespace bustub {
 
+namespace {
+
+// length of the shared prefix of two byte strings
+auto CommonPrefixLen(std::string_view a, std::string_view b) -> size_t {
+  size_t n = std::min(a.size(), b.size());
+  size_t i = 0;
+  while (i < n && a[i] == b[i]) {
+    i++;
+  }
+  return i;
+}
+
+// If node is a plain node with exactly one child, collapse it into that child: the merged node
+// absorbs node's prefix and the edge character, keeping the trie in canonical patricia form.
+auto MergeIfUseless(const std::shared_ptr<const TrieNode> &node) -> std::shared_ptr<const TrieNode> {
+  if (node->is_value_node_ || node->children_.Size() != 1) {
+    return node;
+  }
+  const auto &child = node->children_.ChildAt(0);
+  auto merged = child->Clone();
+  merged->prefix_ = node->prefix_ + node->children_.KeyAt(0) + child->prefix_;
+  return std::shared_ptr<const TrieNode>(std::move(merged));
+}
+
+// Put `val` under `key`, where `key` is the part that remains below `node` (node's own prefix has
+// already been matched by the caller). Returns the copy-on-write replacement for `node`.
+template <class T>
+auto PutRec(const std::shared_ptr<const TrieNode> &node, std::string_view key, std::shared_ptr<T> val)
+    -> std::shared_ptr<const TrieNode> {
+  if (key.empty()) {
+    // the key ends exactly at this node: rebuild it as a value node
+    auto leaf = std::make_shared<TrieNodeWithValue<T>>(node->children_, std::move(val));
+    leaf->prefix_ = node->prefix_;
+    return leaf;
+  }
+  char c = key[0];
+  auto rest = key.substr(1);
+  // positions survive Clone, so one scan serves both the lookup and the write below
+  auto idx = node->children_.FindIndex(c);
+  std::shared_ptr<TrieNode> new_node = node->Clone();
+  if (idx == TrieChildren::NPOS) {
+    // no edge for c yet: the whole remaining key collapses into one leaf
+    auto leaf = std::make_shared<TrieNodeWithValue<T>>(std::move(val));
+    leaf->prefix_ = std::string(rest);
+    new_node->children_.Append(c, std::move(leaf));
+    return new_node;
+  }
+  const auto &child = node->children_.ChildAt(idx);
+  const std::string &p = child->prefix_;
+  size_t common = CommonPrefixLen(rest, p);
+  if (common == p.size()) {
+    // the edge matches entirely, keep descending
+    new_node->children_.SetAt(idx, PutRec<T>(child, rest.substr(common), std::move(val)));
+    return new_node;
+  }
+  // the key diverges inside the edge: split it at the first mismatch
+  auto trimmed = child->Clone();
+  trimmed->prefix_ = p.substr(common + 1);
+  std::shared_ptr<TrieNode> mid;
+  if (rest.size() == common) {
+    // the key ends at the split point, so the split node carries the value
+    mid = std::make_shared<TrieNodeWithValue<T>>(std::move(val));
+  } else {
+    mid = std::make_shared<TrieNode>();
+    auto leaf = std::make_shared<TrieNodeWithValue<T>>(std::move(val));
+    leaf->prefix_ = std::string(rest.substr(common + 1));
+    mid->children_.Append(rest[common], std::move(leaf));
+  }
+  mid->prefix_ = p.substr(0, common);
+  mid->children_.Append(p[common], std::shared_ptr<const TrieNode>(std::move(trimmed)));
+  new_node->children_.SetAt(idx, std::move(mid));
+  return new_node;
+}
+
+// Remove `key` below `node` (node's own prefix has already been matched by the caller).
+// Disengaged means the key was not found; an engaged nullptr means the node was deleted entirely.
+// Cloning and rewiring the parent chain happens while the single descent unwinds, so there is no
+// second pass over the key and no heap-allocated stack of parents.
+auto RemoveRec(const std::shared_ptr<const TrieNode> &node, std::string_view key)
+    -> std::optional<std::shared_ptr<const TrieNode>> {
+  if (key.empty()) {
+    if (!node->is_value_node_) {
+      return std::nullopt;
+    }
+    if (node->children_.Empty()) {
+      return std::shared_ptr<const TrieNode>(nullptr);  // deleted leaf
+    }
+    auto plain = std::make_shared<TrieNode>(node->children_);
+    plain->prefix_ = node->prefix_;
+    return std::shared_ptr<const TrieNode>(std::move(plain));
+  }
+  // positions survive Clone, so one scan serves both the lookup and the write below
+  auto idx = node->children_.FindIndex(key[0]);
+  if (idx == TrieChildren::NPOS) {
+    return std::nullopt;
+  }
+  const auto &child = node->children_.ChildAt(idx);
+  const std::string &p = child->prefix_;
+  auto rest = key.substr(1);
+  if (rest.size() < p.size() || rest.compare(0, p.size(), p) != 0) {
+    return std::nullopt;
+  }
+  auto sub = RemoveRec(child, rest.substr(p.size()));
+  if (!sub.has_value()) {
+    return std::nullopt;
+  }
+  std::shared_ptr<TrieNode> new_node = node->Clone();
+  if (*sub == nullptr) {
+    new_node->children_.EraseAt(idx);
+    if (!new_node->is_value_node_ && new_node->children_.Empty()) {
+      // this node only existed for the deleted key, delete it as well
+      return std::shared_ptr<const TrieNode>(nullptr);
+    }
+  } else {
+    // the caller of each level re-canonicalizes its replacement child
+    new_node->children_.SetAt(idx, MergeIfUseless(*sub));
+  }
+  return std::shared_ptr<const TrieNode>(std::move(new_node));
+}
+
+}  // namespace
+
 template <class T>
 auto Trie::Get(std::string_view key) const -> const T * {
   // You should walk through the trie to find the node corresponding to the key. If the node doesn't exist, return
@@ -14,35 +136,43 @@ auto Trie::Get(std::string_view key) const -> const T * {
   if (root_ == nullptr) {
     return nullptr;
   }
-  std::shared_ptr<const TrieNode> node(root_);
-  std::map<char, std::shared_ptr<const TrieNode>>::const_iterator iter;
-  for (auto c : key) {
-    iter = node->children_.find(c);
-    if (iter != node->children_.cend()) {
-      node = iter->second;
-    } else {
-      node = nullptr;
+  const TrieNode *node = root_.get();
+  size_t i = 0;
+  while (i < key.size()) {
+    auto *child = node->children_.Find(key[i]);
+    if (child == nullptr) {
+      return nullptr;
     }
-    if (node == nullptr) {
+    node = child->get();
+    i++;
+    // the rest of the collapsed edge must match the key as well
+    const std::string &p = node->prefix_;
+    if (key.size() - i < p.size() || key.compare(i, p.size(), p) != 0) {
       return nullptr;
     }
+    i += p.size();
   }
   if (!node->is_value_node_) {
     return nullptr;
   }
-  auto ptr = dynamic_cast<const TrieNodeWithValue<T> *>(node.get());
-  if (ptr == nullptr) {
-    return nullptr;
+  if constexpr (TYPE_TAG<T> != 0) {
+    // tagged type: one branch on the stored tag replaces the dynamic_cast RTTI walk
+    if (node->type_tag_ != TYPE_TAG<T>) {
+      return nullptr;
+    }
+    return static_cast<const TrieNodeWithValue<T> *>(node)->value_.get();
+  } else {
+    auto ptr = dynamic_cast<const TrieNodeWithValue<T> *>(node);
+    if (ptr == nullptr) {
+      return nullptr;
+    }
+    return ptr->value_.get();
   }
-  return ptr->value_.get();
 }
 
 template <class T>
 auto Trie::Put(std::string_view key, T value) const -> Trie {
   // Note that `T` might be a non-copyable type. Always use `std::move` when creating `shared_ptr` on that value.
-
-  // You should walk through the trie and create new nodes if necessary. If the node corresponding to the key already
-  // exists, you should create a new `TrieNodeWithValue`.
   auto val = std::make_shared<T>(std::move(value));
   // special case: key is empty, we directly store value to root!
   if (key.empty()) {
@@ -54,126 +184,32 @@ auto Trie::Put(std::string_view key, T value) const -> Trie {
     }
     return Trie(root);
   }
-  // key is not empty now, we can ensure to update children on some leaf
-  std::shared_ptr<TrieNode> root(nullptr);
-  if (root_ != nullptr) {
-    root = root_->Clone();
-  } else {
-    root = std::make_shared<TrieNode>();
-  }
-  std::shared_ptr<TrieNode> node(root);
-  std::shared_ptr<const TrieNode> next(nullptr);
-  std::shared_ptr<TrieNode> ptr(nullptr);
-  std::shared_ptr<TrieNodeWithValue<T>> leaf(nullptr);
-  std::map<char, std::shared_ptr<const TrieNode>>::const_iterator iter;
-  char last_c = ' ';
-  bool first = true;
-  for (auto c : key) {
-    if (!first) {
-      if (next != nullptr) {
-        ptr = next->Clone();
-      } else {
-        ptr = std::make_shared<TrieNode>();
-      }
-      node->children_[last_c] = ptr;
-      node = ptr;
-    }
-    first = false;
-    iter = node->children_.find(c);
-    if (iter != node->children_.cend()) {
-      next = iter->second;
-    } else {
-      next = nullptr;
-    }
-    last_c = c;
-  }
-  // now, we reach end of key, next is our target
-  if (next != nullptr) {
-    leaf = std::make_shared<TrieNodeWithValue<T>>(next->children_, val);
-  } else {
-    leaf = std::make_shared<TrieNodeWithValue<T>>(val);
-  }
-  node->children_[last_c] = leaf;
-  return Trie(root);
+  // the root never has a prefix of its own, so the whole key remains below it
+  std::shared_ptr<const TrieNode> root = root_ != nullptr ? root_ : std::make_shared<const TrieNode>();
+  return Trie(PutRec<T>(root, key, std::move(val)));
 }
 
 auto Trie::Remove(std::string_view key) const -> Trie {
-  // You should walk through the trie and remove nodes if necessary. If the node doesn't contain a value any more,
-  // you should convert it to `TrieNode`. If a node doesn't have children any more, you should remove it.
-
-  // Remove is same as Put, except update
   if (root_ == nullptr) {
     return Trie(root_);
   }
   // special case: key is empty
   if (key.empty()) {
-    if (root_->children_.empty()) {
+    if (!root_->is_value_node_) {
+      return Trie(root_);
+    }
+    if (root_->children_.Empty()) {
       return Trie(nullptr);  // root is deleted leaf now
     }
     auto root = std::make_shared<TrieNode>(root_->children_);
     return Trie(root);
   }
-
-  // now key is not empty, we can ensure to update children in stack
-  std::shared_ptr<TrieNode> root = root_->Clone();
-  std::shared_ptr<TrieNode> node(root);
-  std::shared_ptr<const TrieNode> next(nullptr);
-  std::map<char, std::shared_ptr<const TrieNode>>::const_iterator iter;
-  std::stack<std::shared_ptr<TrieNode>> stack;
-  for (auto c : key) {
-    stack.push(node);
-    iter = node->children_.find(c);
-    if (iter != node->children_.cend()) {
-      next = iter->second;
-    } else {
-      next = nullptr;
-    }
-    if (next == nullptr) {
-      return Trie(root_);
-    }
-    node = next->Clone();
-  }
-  // now, we reach end of key, node is our target and it should has value
-  if (!node->is_value_node_) {
+  auto result = RemoveRec(root_, key);
+  if (!result.has_value()) {
     return Trie(root_);
   }
-  // now node has no value
-  if (node->children_.empty()) {
-    // if node has no children(means it's deleted leaf now)
-    // we should go back to check if parent is also deleted leaf(no value and children size = 1)
-    while (!stack.empty()) {
-      node = stack.top();
-      if (node->is_value_node_ || node->children_.size() > 1) {
-        break;
-      }
-      stack.pop();
-    }
-  } else {
-    // node is not leaf, convert it to no-value node
-    // push it to stack, to chain it in new Trie
-    stack.push(std::make_shared<TrieNode>(node->children_));
-  }
-  // only one node, deleted
-  if (stack.empty()) {
-    return Trie(nullptr);
-  }
-  std::stack<std::shared_ptr<TrieNode>> reversed;
-  while (!stack.empty()) {
-    reversed.push(stack.top());
-    stack.pop();
-  }
-  // we always asume: reversed is not empty
-  for (auto c : key) {
-    node = reversed.top();
-    reversed.pop();
-    // so we has to check reversed empty, after pop
-    if (reversed.empty()) {
-      node->children_.erase(c);
-      break;
-    }
-    node->children_[c] = reversed.top();
-  }
-  return Trie(root);
+  // the root is never merged into its child: its prefix has to stay empty
+  return Trie(*result);
 }
 
 // Below are explicit instantiation of template functions.
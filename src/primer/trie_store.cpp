@@ -1,59 +1,90 @@
 #include "primer/trie_store.h"
+#include <algorithm>
 #include "common/exception.h"
 
 namespace bustub {
 
+auto TrieStore::TryProtect(const TrieNode *root) -> std::atomic<const TrieNode *> * {
+  for (auto &slot : hazard_slots_) {
+    const TrieNode *expected = nullptr;
+    if (slot.compare_exchange_strong(expected, root)) {
+      return &slot;
+    }
+  }
+  return nullptr;
+}
+
+void TrieStore::PublishVersion(Trie new_root) {
+  // writers are serialized by write_lock_, so reading root_ without root_lock_ is fine here
+  Trie old = root_;
+  {
+    const std::lock_guard<std::mutex> lock(root_lock_);
+    root_ = new_root;
+  }
+  root_ptr_.store(new_root.root_.get());
+  // the old version may still be pinned by a hazard slot; keep it until a scan proves otherwise
+  retired_.push_back(std::move(old));
+  ScanRetired();
+}
+
+void TrieStore::ScanRetired() {
+  auto hazarded = [this](const TrieNode *root) {
+    if (root == nullptr) {
+      return false;
+    }
+    return std::any_of(hazard_slots_.begin(), hazard_slots_.end(),
+                       [root](std::atomic<const TrieNode *> &slot) { return slot.load() == root; });
+  };
+  auto iter = std::remove_if(retired_.begin(), retired_.end(),
+                             [&](const Trie &trie) { return !hazarded(trie.root_.get()); });
+  retired_.erase(iter, retired_.end());
+}
+
 template <class T>
 auto TrieStore::Get(std::string_view key) -> std::optional<ValueGuard<T>> {
-  // Pseudo-code:
-  // (1) Take the root lock, get the root, and release the root lock. Don't lookup the value in the
-  //     trie while holding the root lock.
-  // (2) Lookup the value in the trie.
-  // (3) If the value is found, return a ValueGuard object that holds a reference to the value and the
-  //     root. Otherwise, return std::nullopt.
-
-  // step 1
+  for (;;) {
+    const TrieNode *root = root_ptr_.load();
+    if (root == nullptr) {
+      return std::nullopt;  // empty trie, nothing to look up or protect
+    }
+    auto *slot = TryProtect(root);
+    if (slot == nullptr) {
+      break;  // every slot is busy, fall back to an owning snapshot
+    }
+    if (root_ptr_.load() == root) {
+      // the version is pinned now; walk it without touching any reference count
+      Trie view(std::shared_ptr<const TrieNode>(std::shared_ptr<const TrieNode>(), root));
+      auto val = view.Get<T>(key);
+      if (val == nullptr) {
+        slot->store(nullptr);
+        return std::nullopt;
+      }
+      return ValueGuard<T>(slot, *val);
+    }
+    // a writer published a newer version before we pinned this one, retry
+    slot->store(nullptr);
+  }
   root_lock_.lock();
   auto trie = root_;
   root_lock_.unlock();
-  // step 2
   auto val = trie.Get<T>(key);
-  // step 3
   if (val == nullptr) {
     return std::nullopt;
   }
-  return ValueGuard(trie, *val);
+  return ValueGuard<T>(trie, *val);
 }
 
 template <class T>
 void TrieStore::Put(std::string_view key, T value) {
-  // You will need to ensure there is only one writer at a time. Think of how you can achieve this.
-  // The logic should be somehow similar to `TrieStore::Get`.
-
   // all ops will by guarded by lock_guard
   const std::lock_guard<std::mutex> lock(write_lock_);
-  root_lock_.lock();
-  auto trie = root_;
-  root_lock_.unlock();
-  auto new_trie = trie.Put(key, std::move(value));
-  root_lock_.lock();
-  root_ = new_trie;
-  root_lock_.unlock();
+  PublishVersion(root_.Put(key, std::move(value)));
 }
 
 void TrieStore::Remove(std::string_view key) {
-  // You will need to ensure there is only one writer at a time. Think of how you can achieve this.
-  // The logic should be somehow similar to `TrieStore::Get`.
-
   // all ops will by guarded by lock_guard
   const std::lock_guard<std::mutex> lock(write_lock_);
-  root_lock_.lock();
-  auto trie = root_;
-  root_lock_.unlock();
-  auto new_trie = trie.Remove(key);
-  root_lock_.lock();
-  root_ = new_trie;
-  root_lock_.unlock();
+  PublishVersion(root_.Remove(key));
 }
 
 // Below are explicit instantiation of template functions.
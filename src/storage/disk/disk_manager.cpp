@@ -93,6 +93,25 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
   db_io_.flush();
 }
 
+/**
+ * Write a run of consecutive pages into the disk file with a single seek and write
+ */
+void DiskManager::WritePages(page_id_t first_page_id, const char *page_data, size_t num_pages) {
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  size_t offset = static_cast<size_t>(first_page_id) * BUSTUB_PAGE_SIZE;
+  // set write cursor to offset
+  num_writes_ += static_cast<int>(num_pages);
+  db_io_.seekp(offset);
+  db_io_.write(page_data, static_cast<std::streamsize>(num_pages * BUSTUB_PAGE_SIZE));
+  // check for I/O error
+  if (db_io_.bad()) {
+    LOG_DEBUG("I/O error while writing");
+    return;
+  }
+  // needs to flush to keep disk file in sync
+  db_io_.flush();
+}
+
 /**
  * Read the contents of the specified page into the given memory area
  */
@@ -103,12 +122,16 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   if (offset > GetFileSize(file_name_)) {
     LOG_DEBUG("I/O error reading past end of file");
     // std::cerr << "I/O error while reading" << std::endl;
+    // the caller's frame may hold another page's stale bytes; every exit from this function
+    // must leave all BUSTUB_PAGE_SIZE bytes of page_data defined
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
   } else {
     // set read cursor to offset
     db_io_.seekp(offset);
     db_io_.read(page_data, BUSTUB_PAGE_SIZE);
     if (db_io_.bad()) {
       LOG_DEBUG("I/O error while reading");
+      memset(page_data, 0, BUSTUB_PAGE_SIZE);  // same: never hand back stale frame contents
       return;
     }
     // if file ends before reading BUSTUB_PAGE_SIZE
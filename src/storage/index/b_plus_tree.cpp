@@ -1,5 +1,11 @@
+#include <cstring>
 #include <sstream>
 #include <string>
+#include <type_traits>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -26,14 +32,91 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPool
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
-  auto guard = bpm_->FetchPageRead(header_page_id_);
-  auto header = reinterpret_cast<const BPlusTreeHeaderPage *>(guard.GetData());
-  return header->root_page_id_ == INVALID_PAGE_ID;
+auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return cached_root_.load(std::memory_order_acquire) == INVALID_PAGE_ID; }
+
+/*
+ * Read-latch the current root through the cached root id, skipping the header page entirely.
+ * A root change publishes the new id into cached_root_ before the old root's write latch is
+ * released, so once we hold the latch a re-check of the id proves the page is still the root;
+ * a freshly published root is write-latched until it is initialized, so latching it blocks
+ * instead of exposing a half-built page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FetchRootRead() -> std::optional<ReadPageGuard> {
+  while (true) {
+    auto root_id = cached_root_.load(std::memory_order_acquire);
+    if (root_id == INVALID_PAGE_ID) {
+      return std::nullopt;
+    }
+    auto guard = bpm_->FetchPageRead(root_id);
+    if (cached_root_.load(std::memory_order_acquire) == root_id) {
+      return guard;
+    }
+    // the root split between our load and our latch; retry against the new id
+  }
 }
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
+/*
+ * Seqlock-style descent: internal nodes are only pinned, never latched. Each node is read
+ * under its structural version (Page::ReadSeq); the version is validated after computing the
+ * child slot and again after the child is pinned, so a stale or torn child id is never
+ * followed. Writers bump the version to odd before restructuring a retained path (see Insert),
+ * which also covers the hand-off to the leaf: a leaf cannot split without its parent being
+ * marked, so revalidating the parent after read-latching the leaf proves the leaf still covers
+ * this key range. Any mismatch falls back to the latched descent in GetValue.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetValueOptimistic(const KeyType &key, std::vector<ValueType> *result) -> std::optional<bool> {
+  auto root_id = cached_root_.load(std::memory_order_acquire);
+  if (root_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  auto node = bpm_->FetchPageBasic(root_id);
+  if (cached_root_.load(std::memory_order_acquire) != root_id) {
+    return std::nullopt;  // the root changed under us
+  }
+  auto v = node.Seq();
+  if ((v & 1) != 0) {
+    return std::nullopt;  // a writer is restructuring the root right now
+  }
+  while (true) {
+    auto page = node.template As<BPlusTreePage>();
+    if (page->IsLeafPage()) {
+      break;
+    }
+    auto internal = reinterpret_cast<const InternalPage *>(page);
+    auto idx = InternalKeyIndex(internal, key);
+    auto child_id = internal->ValueAt(idx);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (node.Seq() != v) {
+      return std::nullopt;  // this node changed while we were reading it; child_id is suspect
+    }
+    auto child = bpm_->FetchPageBasic(child_id);
+    auto cv = child.Seq();
+    if ((cv & 1) != 0 || node.Seq() != v) {
+      return std::nullopt;
+    }
+    node = std::move(child);
+    v = cv;
+  }
+  // the leaf's records are read under a real read latch; the version check after latching
+  // catches a split that slipped in between our validation of the parent and the latch
+  auto leaf_guard = bpm_->FetchPageRead(node.PageId());
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (node.Seq() != v) {
+    return std::nullopt;
+  }
+  auto leaf = reinterpret_cast<const LeafPage *>(leaf_guard.GetData());
+  auto idx = LeafKeyIndex(leaf, key);
+  if (idx != -1) {
+    result->emplace_back(leaf->ValueAt(idx));
+    return true;
+  }
+  return false;
+}
+
 /*
  * Return the only value that associated with input key
  * This method is used for point query
@@ -41,14 +124,14 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
-  auto guard = bpm_->FetchPageRead(header_page_id_);
-  auto header = reinterpret_cast<const BPlusTreeHeaderPage *>(guard.GetData());
-  auto root_id = header->root_page_id_;
-  if (root_id == INVALID_PAGE_ID) {
+  if (auto found = GetValueOptimistic(key, result); found.has_value()) {
+    return *found;
+  }
+  auto root = FetchRootRead();
+  if (!root.has_value()) {
     return false;
   }
-  auto parent = bpm_->FetchPageRead(root_id);
-  guard.Drop();
+  auto parent = std::move(*root);
 
   // parent has alread hold a guard for some page, in loop starting
   const BPlusTreePage *page = nullptr;
@@ -84,89 +167,189 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * @return: since we only support unique key, if user try to insert duplicate
  * keys return false, otherwise return true.
  */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::InsertOptimistic(const KeyType &key, const ValueType &value) -> std::optional<bool> {
+  auto root = FetchRootRead();
+  if (!root.has_value()) {
+    return std::nullopt;  // only the pessimistic path may create the root
+  }
+  auto parent = std::move(*root);
+  if (reinterpret_cast<const BPlusTreePage *>(parent.GetData())->IsLeafPage()) {
+    // a leaf root has no parent latch to pin it in place across a read-to-write upgrade,
+    // and such a tree is one split away from growing out of this shape anyway
+    return std::nullopt;
+  }
+  while (true) {
+    auto internal = reinterpret_cast<const InternalPage *>(parent.GetData());
+    auto idx = InternalKeyIndex(internal, key);
+    auto child_id = internal->ValueAt(idx);
+    auto child = bpm_->FetchPageRead(child_id);
+    if (!reinterpret_cast<const BPlusTreePage *>(child.GetData())->IsLeafPage()) {
+      parent = std::move(child);  // coupled: the old parent read latch drops here
+      continue;
+    }
+    // The child is the target leaf: trade its read latch for a write latch. The parent stays
+    // read-latched across the gap and any split of this leaf must write-latch the parent
+    // first, so the leaf cannot be restructured before our write latch lands.
+    child.Drop();
+    auto leaf_guard = bpm_->FetchPageWrite(child_id);
+    auto leaf = reinterpret_cast<LeafPage *>(leaf_guard.GetDataMut());
+    auto leafPos = LeafInsertIndex(leaf, key);
+    if (leafPos < leaf->GetSize() && comparator_(key, leaf->KeyAt(leafPos)) == 0) {  // duplicate key
+      return false;
+    }
+    if (!IsSafeModify(leaf, true)) {
+      return std::nullopt;  // the leaf must split; redo the descent write-coupled
+    }
+    InsertIntoLeaf(leaf, leafPos, key, value);
+    return true;
+  }
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
+  // most inserts land in a leaf with spare room, which the optimistic pass handles without
+  // ever write-latching an inner node; only split-bound inserts pay for write coupling
+  if (auto inserted = InsertOptimistic(key, value); inserted.has_value()) {
+    return *inserted;
+  }
+
   // Declaration of context instance.
   Context ctx;
 
-  ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
-  auto header = reinterpret_cast<BPlusTreeHeaderPage *>(ctx.header_page_->GetDataMut());
-  if (header->root_page_id_ == INVALID_PAGE_ID) {  // empty tree
-    auto guard = bpm_->NewPageGuarded(&(header->root_page_id_));
-    auto leaf = reinterpret_cast<LeafPage *>(guard.GetDataMut());
-    // init for new page
-    leaf->Init(leaf_max_size_);
-    // insert kv into new page
-    leaf->IncreaseSize(1);
-    leaf->SetKeyAt(0, key);
-    leaf->SetValueAt(0, value);
-    return true;
-  }
-  ctx.root_page_id_ = header->root_page_id_;
-  auto root = bpm_->FetchPageWrite(ctx.root_page_id_);
-
   // in every loop start, root holds page write latch already
+  BPlusTreeHeaderPage *header = nullptr;
+  WritePageGuard root;
   BPlusTreePage *page = nullptr;
   InternalPage *internal = nullptr;
   LeafPage *leaf = nullptr;
   char *ptr = nullptr;
   auto idx = -1;
-  auto res = 0;
   page_id_t pid, pid2, splited_pid;
   auto leafPos = -1;
+  // The leaf split's right sibling is allocated while no latches are held: NewPage may have to
+  // evict and write back a dirty page, and paying that under the write-latched path would stall
+  // every thread queued on these nodes. The first descent that finds a full leaf backs all the
+  // way out, allocates a spare page, and redoes the descent with the spare in hand.
+  std::optional<BasicPageGuard> spare;
+  // The header page's write latch is only needed when the root id itself can change: an empty
+  // tree or a split cascade that reaches the root. Descents start from cached_root_ without it
+  // (revalidated once the presumed root is latched, as in FetchRootRead) and restart with the
+  // header held only when one of those two cases actually comes up.
+  bool with_header = false;
+  bool root_safe = true;
   while (true) {
-    ptr = root.GetDataMut();
-    splited_pid = root.PageId();  // actually, it will be updated to leaf node pageid after loop, not too bad
-    page = reinterpret_cast<BPlusTreePage *>(ptr);
-    if (IsSafeModify(page, true)) {
-      // release all in write set
-      if (ctx.header_page_.has_value()) {
-        ctx.header_page_ = std::nullopt;
+    page_id_t next_pid;
+    if (with_header) {
+      ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
+      header = reinterpret_cast<BPlusTreeHeaderPage *>(ctx.header_page_->GetDataMut());
+      if (header->root_page_id_ == INVALID_PAGE_ID) {  // empty tree
+        auto guard = bpm_->NewPageGuarded(&(header->root_page_id_));
+        auto new_leaf = reinterpret_cast<LeafPage *>(guard.GetDataMut());
+        // init for new page
+        new_leaf->Init(leaf_max_size_);
+        // insert kv into new page
+        new_leaf->IncreaseSize(1);
+        new_leaf->SetKeyAt(0, key);
+        new_leaf->SetValueAt(0, value);
+        // publish only after the leaf is fully initialized; readers load cached_root_ with acquire
+        cached_root_.store(header->root_page_id_, std::memory_order_release);
+        return true;
       }
-      while (!ctx.write_set_.empty()) {
-        ctx.write_set_.pop_front();
+      ctx.root_page_id_ = header->root_page_id_;
+    } else {
+      ctx.root_page_id_ = cached_root_.load(std::memory_order_acquire);
+      if (ctx.root_page_id_ == INVALID_PAGE_ID) {
+        with_header = true;  // creating the root requires the header
+        continue;
       }
     }
-    ctx.write_set_.emplace_back(std::move(root));
-
-    // internal page
-    if (!page->IsLeafPage()) {
-      internal = reinterpret_cast<InternalPage *>(ptr);
-      idx = InternalKeyIndex(internal, key);
-      root = bpm_->FetchPageWrite(internal->ValueAt(idx));  // jump to next level page
-      continue;
-    }
+    next_pid = ctx.root_page_id_;
 
-    // leaf page
-    leaf = reinterpret_cast<LeafPage *>(ptr);
-    for (int i = 0; i < leaf->GetSize(); i++) {
-      res = comparator_(key, leaf->KeyAt(i));
-      if (res == 0) {  // duplicate key
-        return false;
+    bool retry = false;
+    while (true) {
+      // construct each level's guard in its final slot rather than fetching into a local and
+      // moving it in; the current node is always Back(), which survives the release below
+      // even though releasing shifts the remaining element
+      ptr = ctx.write_set_.EmplaceBack(bpm_->FetchPageWrite(next_pid), -1).first.GetDataMut();
+      splited_pid = ctx.write_set_.Back().first.PageId();  // updated to the leaf's id after the loop, not too bad
+      page = reinterpret_cast<BPlusTreePage *>(ptr);
+      if (ctx.write_set_.Size() == 1) {
+        if (!with_header && cached_root_.load(std::memory_order_acquire) != ctx.root_page_id_) {
+          // the root changed between the load and our latch; redo against the new id
+          ctx.write_set_.Clear();
+          retry = true;
+          break;
+        }
+        root_safe = IsSafeModify(page, true);
+      }
+      if (IsSafeModify(page, true)) {
+        // release everything retained above this node
+        if (ctx.header_page_.has_value()) {
+          ctx.header_page_ = std::nullopt;
+        }
+        while (ctx.write_set_.Size() > 1) {
+          ctx.write_set_.PopFront();
+        }
       }
-      if (res > 0) {
+
+      // internal page
+      if (!page->IsLeafPage()) {
+        internal = reinterpret_cast<InternalPage *>(ptr);
+        idx = InternalKeyIndex(internal, key);
+        ctx.write_set_.Back().second = idx;  // remembered for the ascent after a split
+        next_pid = internal->ValueAt(idx);  // jump to next level page
         continue;
       }
-      // we have found target page and pos
-      leafPos = i;
+
+      // leaf page
+      leaf = reinterpret_cast<LeafPage *>(ptr);
+      leafPos = LeafInsertIndex(leaf, key);
+      if (leafPos < leaf->GetSize() && comparator_(key, leaf->KeyAt(leafPos)) == 0) {  // duplicate key
+        return false;
+      }
+      // after search leaf, we should break loop
       break;
     }
-    // after search leaf, we should break loop
-    // special case: leaf page was found but it should be in right-most pos?
-    if (leafPos == -1) {
-      leafPos = leaf->GetSize();
+    if (retry) {
+      continue;
     }
-    break;
-  }
 
-  // key < key[i], this is where we should insert value
-  if (IsSafeModify(leaf, true)) {  // no need to split first
-    InsertIntoLeaf(leaf, leafPos, key, value);
-    return true;
+    // key < key[i], this is where we should insert value
+    if (IsSafeModify(leaf, true)) {  // no need to split first
+      InsertIntoLeaf(leaf, leafPos, key, value);
+      return true;
+    }
+    if (!with_header && !root_safe && ctx.write_set_.begin()->first.PageId() == ctx.root_page_id_) {
+      // the cascade may reach the root and change its id, which needs the header latch; the
+      // header must be taken before any node latch, so back out entirely and redo with it
+      ctx.write_set_.Clear();
+      with_header = true;
+      continue;
+    }
+    if (spare.has_value()) {
+      break;  // the split below uses the spare allocated on the previous pass
+    }
+    // back out, allocate the sibling latch-free, then re-verify the split is still needed
+    ctx.write_set_.Clear();
+    ctx.header_page_ = std::nullopt;
+    page_id_t spare_pid;
+    spare = bpm_->NewPageGuarded(&spare_pid);
+  }
+  // When the root itself splits we allocate its replacement up front, already write-latched,
+  // and publish its id into cached_root_ while the old root's write latch is still held: any
+  // reader that picks up the new id blocks on the new root's latch until it is filled in below,
+  // and any reader still latching the old id fails FetchRootRead's revalidation and retries.
+  std::optional<WritePageGuard> new_root_guard;
+  // Mark every retained page as restructuring (version goes odd); optimistic readers that
+  // overlap any of them fail their version checks and fall back to the latched descent. Each
+  // page is bumped even again below, once its part of the restructuring is complete.
+  for (auto &entry : ctx.write_set_) {
+    entry.first.BumpSeq();
   }
   // we should split node
   // only when root node is leaf node, we has to record split_pid for it
-  pid = SplitLeaf(leaf);
+  pid = SplitLeaf(leaf, std::move(*spare));
   auto guard = bpm_->FetchPageWrite(pid);
   auto leaf2 = reinterpret_cast<LeafPage *>(guard.GetDataMut());
   // has to decide which page inset, left or right?
@@ -179,19 +362,37 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
 
   // modify internal now, prepare loop
   auto splitKey = leaf2->KeyAt(0);
-  ctx.write_set_.pop_back();
+  if (ctx.IsRootPage(splited_pid)) {  // the pop below releases the leaf root's write latch
+    page_id_t new_root_id;
+    new_root_guard.emplace(bpm_, bpm_->NewPage(&new_root_id));
+    new_root_guard->BumpSeq();  // odd until the new root is filled in at the end
+    header->root_page_id_ = new_root_id;
+    cached_root_.store(new_root_id, std::memory_order_release);
+  }
+  ctx.write_set_.Back().first.BumpSeq();  // the leaf's restructuring is done
+  ctx.write_set_.PopBack();
   guard.Drop();
   // loop condition: splitKey and pid set
-  while (!ctx.write_set_.empty()) {
-    root = std::move(ctx.write_set_.back());
+  while (!ctx.write_set_.Empty()) {
+    // the new right sibling's pointer goes right after the slot the descent took; we still
+    // hold this page's write latch, so the remembered index cannot have gone stale
+    idx = ctx.write_set_.Back().second + 1;
+    root = std::move(ctx.write_set_.Back().first);
     internal = reinterpret_cast<InternalPage *>(root.GetDataMut());
-    idx = InternalKeyIndex(internal, splitKey) + 1;
     if (IsSafeModify(internal, true)) {  // no need to split first
       InsertIntoInternal(internal, idx, splitKey, pid);
+      root.BumpSeq();  // even again: this level absorbed the split
       break;
     }
     // we should split internal
     splited_pid = root.PageId();
+    if (ctx.IsRootPage(splited_pid)) {  // root's guard stays in `root` until return, so publish now
+      page_id_t new_root_id;
+      new_root_guard.emplace(bpm_, bpm_->NewPage(&new_root_id));
+      new_root_guard->BumpSeq();  // odd until the new root is filled in at the end
+      header->root_page_id_ = new_root_id;
+      cached_root_.store(new_root_id, std::memory_order_release);
+    }
     pid2 = SplitInternal(internal);
     guard = bpm_->FetchPageWrite(pid2);
     auto internal2 = reinterpret_cast<InternalPage *>(guard.GetDataMut());
@@ -206,13 +407,13 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     // prepare loop
     splitKey = internal2->KeyAt(0);
     pid = pid2;
-    ctx.write_set_.pop_back();
+    root.BumpSeq();  // even again: this level's split is complete
+    ctx.write_set_.PopBack();
     guard.Drop();
   }
   // special case: what if we need to split root node?
-  if (ctx.IsRootPage(splited_pid)) {
-    auto guard = bpm_->NewPageGuarded(&(header->root_page_id_));
-    auto internal = reinterpret_cast<InternalPage *>(guard.GetDataMut());
+  if (new_root_guard.has_value()) {
+    auto internal = reinterpret_cast<InternalPage *>(new_root_guard->GetDataMut());
     // init for new page
     internal->Init(internal_max_size_);
     // insert kv into new page
@@ -220,7 +421,8 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
     internal->SetValueAt(0, splited_pid);
     internal->SetKeyAt(1, splitKey);
     internal->SetValueAt(1, pid);
-    guard.Drop();
+    new_root_guard->BumpSeq();  // even: the new root is now readable optimistically
+    new_root_guard = std::nullopt;  // readers parked on the new root's latch may proceed
   }
   return true;
 }
@@ -252,14 +454,11 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
-  auto guard = bpm_->FetchPageRead(header_page_id_);
-  auto header = reinterpret_cast<const BPlusTreeHeaderPage *>(guard.GetData());
-  auto root_id = header->root_page_id_;
-  if (root_id == INVALID_PAGE_ID) {
+  auto root = FetchRootRead();
+  if (!root.has_value()) {
     return End();  // return end()
   }
-  auto parent = bpm_->FetchPageRead(root_id);
-  guard.Drop();
+  auto parent = std::move(*root);
 
   // parent has alread hold a guard for some page, in loop starting
   const BPlusTreePage *page = nullptr;
@@ -286,14 +485,11 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
-  auto guard = bpm_->FetchPageRead(header_page_id_);
-  auto header = reinterpret_cast<const BPlusTreeHeaderPage *>(guard.GetData());
-  auto root_id = header->root_page_id_;
-  if (root_id == INVALID_PAGE_ID) {
+  auto root = FetchRootRead();
+  if (!root.has_value()) {
     return End();
   }
-  auto parent = bpm_->FetchPageRead(root_id);
-  guard.Drop();
+  auto parent = std::move(*root);
 
   // parent has alread hold a guard for some page, in loop starting
   const BPlusTreePage *page = nullptr;
@@ -331,16 +527,95 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE { return INDEXITERATOR_TYPE();
  * @return Page id of the root of this tree
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
-  auto guard = bpm_->FetchPageRead(header_page_id_);
-  auto header = reinterpret_cast<const BPlusTreeHeaderPage *>(guard.GetData());
-  return header->root_page_id_;
-}
+auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t { return cached_root_.load(std::memory_order_acquire); }
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
 
+/*
+ * Build an empty tree from a batch of key-value pairs in one bottom-up pass
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> &kvs) -> bool {
+  // the header write latch serializes this against every other root change, and holding it for
+  // the whole build is cheap: the pages below stay unreachable (cached_root_ stays INVALID, so
+  // optimistic passes bail out and pessimistic ones queue on the header) until the publish at
+  // the end
+  auto header_guard = bpm_->FetchPageWrite(header_page_id_);
+  auto header = reinterpret_cast<BPlusTreeHeaderPage *>(header_guard.GetDataMut());
+  if (header->root_page_id_ != INVALID_PAGE_ID) {
+    return false;  // only an empty tree can be built bottom-up
+  }
+  if (kvs.empty()) {
+    return true;
+  }
+  // stable sort plus adjacent dedup keeps the first occurrence of each duplicate, which is
+  // exactly what the equivalent sequence of Insert calls would have kept
+  std::stable_sort(kvs.begin(), kvs.end(),
+                   [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) < 0; });
+  kvs.erase(std::unique(kvs.begin(), kvs.end(),
+                        [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) == 0; }),
+            kvs.end());
+
+  // one entry per node built on the current level: the node's page id plus its smallest key,
+  // which becomes its separator in the parent
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  // leave one slot free per node so the first few point inserts after the load do not all
+  // split; the sorted input is copied straight into each leaf's mapping array
+  auto per_leaf = std::max(1, leaf_max_size_ - 1);
+  LeafPage *prev_leaf = nullptr;
+  std::optional<BasicPageGuard> prev_guard;
+  for (size_t pos = 0; pos < kvs.size(); pos += per_leaf) {
+    auto take = std::min(static_cast<size_t>(per_leaf), kvs.size() - pos);
+    page_id_t pid;
+    auto guard = bpm_->NewPageGuarded(&pid);
+    auto leaf = reinterpret_cast<LeafPage *>(guard.GetDataMut());
+    leaf->Init(leaf_max_size_);
+    leaf->SetSize(static_cast<int>(take));
+    std::memcpy(static_cast<void *>(leaf->GetArray()), static_cast<const void *>(kvs.data() + pos),
+                take * sizeof(*leaf->GetArray()));
+    if (prev_leaf != nullptr) {
+      prev_leaf->SetNextPageId(pid);
+    }
+    level.emplace_back(kvs[pos].first, pid);
+    prev_leaf = leaf;
+    prev_guard = std::move(guard);
+  }
+  prev_guard = std::nullopt;
+
+  // each round groups the current level under new internal nodes until one node remains
+  auto fan = static_cast<size_t>(std::max(2, internal_max_size_ - 1));
+  while (level.size() > 1) {
+    std::vector<std::pair<KeyType, page_id_t>> parents;
+    for (size_t pos = 0; pos < level.size();) {
+      auto take = std::min(fan, level.size() - pos);
+      if (level.size() - pos - take == 1 && take > 2) {
+        take -= 1;  // do not strand a single child in the last node of this level
+      }
+      page_id_t pid;
+      auto guard = bpm_->NewPageGuarded(&pid);
+      auto internal = reinterpret_cast<InternalPage *>(guard.GetDataMut());
+      internal->Init(internal_max_size_);
+      internal->SetSize(static_cast<int>(take));
+      for (size_t j = 0; j < take; j++) {
+        internal->SetValueAt(static_cast<int>(j), level[pos + j].second);
+        if (j > 0) {  // slot 0 holds no key, as everywhere else in the tree
+          internal->SetKeyAt(static_cast<int>(j), level[pos + j].first);
+        }
+      }
+      parents.emplace_back(level[pos].first, pid);
+      pos += take;
+    }
+    level = std::move(parents);
+  }
+
+  // publish only once the whole tree is wired up; readers load cached_root_ with acquire
+  header->root_page_id_ = level.front().second;
+  cached_root_.store(header->root_page_id_, std::memory_order_release);
+  return true;
+}
+
 /*
  * This method is used for test only
  * Read data from file and insert one by one
@@ -349,10 +624,18 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *txn) {
   int64_t key;
   std::ifstream input(file_name);
+  std::vector<std::pair<KeyType, ValueType>> kvs;
   while (input >> key) {
     KeyType index_key;
     index_key.SetFromInteger(key);
     RID rid(key);
+    kvs.emplace_back(index_key, rid);
+  }
+  // an empty tree takes the whole batch in one bottom-up pass; otherwise insert per key
+  if (BulkLoad(kvs)) {
+    return;
+  }
+  for (const auto &[index_key, rid] : kvs) {
     Insert(index_key, rid, txn);
   }
 }
@@ -380,11 +663,29 @@ void BPLUSTREE_TYPE::BatchOpsFromFile(const std::string &file_name, Transaction
   int64_t key;
   char instruction;
   std::ifstream input(file_name);
-  while (input) {
-    input >> instruction >> key;
+  // the leading run of inserts goes through the bulkload when the tree starts empty; once the
+  // first delete shows up (or the tree was not empty) operations apply one by one as before
+  std::vector<std::pair<KeyType, ValueType>> prefix;
+  bool batching = true;
+  auto flush_prefix = [&] {
+    batching = false;
+    if (!BulkLoad(prefix)) {
+      for (const auto &[index_key, rid] : prefix) {
+        Insert(index_key, rid, txn);
+      }
+    }
+  };
+  while (input >> instruction >> key) {
     RID rid(key);
     KeyType index_key;
     index_key.SetFromInteger(key);
+    if (batching && instruction == 'i') {
+      prefix.emplace_back(index_key, rid);
+      continue;
+    }
+    if (batching) {
+      flush_prefix();
+    }
     switch (instruction) {
       case 'i':
         Insert(index_key, rid, txn);
@@ -396,6 +697,9 @@ void BPLUSTREE_TYPE::BatchOpsFromFile(const std::string &file_name, Transaction
         break;
     }
   }
+  if (batching) {
+    flush_prefix();
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -521,17 +825,17 @@ void BPLUSTREE_TYPE::ToGraph(page_id_t page_id, const BPlusTreePage *page, std::
     // Print table end
     out << "</TABLE>>];\n";
     // Print leaves
+    // remember the previous child instead of re-fetching the left sibling each iteration,
+    // so each node costs one buffer-pool lookup rather than two
+    auto prev_child_id = INVALID_PAGE_ID;
+    bool prev_child_is_leaf = false;
     for (int i = 0; i < inner->GetSize(); i++) {
       auto child_guard = bpm_->FetchPageBasic(inner->ValueAt(i));
       auto child_page = child_guard.template As<BPlusTreePage>();
       ToGraph(child_guard.PageId(), child_page, out);
-      if (i > 0) {
-        auto sibling_guard = bpm_->FetchPageBasic(inner->ValueAt(i - 1));
-        auto sibling_page = sibling_guard.template As<BPlusTreePage>();
-        if (!sibling_page->IsLeafPage() && !child_page->IsLeafPage()) {
-          out << "{rank=same " << internal_prefix << sibling_guard.PageId() << " " << internal_prefix
-              << child_guard.PageId() << "};\n";
-        }
+      if (i > 0 && !prev_child_is_leaf && !child_page->IsLeafPage()) {
+        out << "{rank=same " << internal_prefix << prev_child_id << " " << internal_prefix << child_guard.PageId()
+            << "};\n";
       }
       out << internal_prefix << page_id << ":p" << child_guard.PageId() << " -> ";
       if (child_page->IsLeafPage()) {
@@ -539,6 +843,8 @@ void BPLUSTREE_TYPE::ToGraph(page_id_t page_id, const BPlusTreePage *page, std::
       } else {
         out << internal_prefix << child_guard.PageId() << ";\n";
       }
+      prev_child_id = child_guard.PageId();
+      prev_child_is_leaf = child_page->IsLeafPage();
     }
   }
 }
@@ -584,6 +890,31 @@ auto BPLUSTREE_TYPE::ToPrintableBPlusTree(page_id_t root_id) -> PrintableBPlusTr
   return proot;
 }
 
+#ifdef __AVX2__
+/**
+ * Count the keys in slots [lo, hi) of a contiguous raw-int64 key array that are <= target.
+ * Because the slots are sorted, that count is exactly how far past lo - 1 the search key
+ * lands, so the caller gets a lower bound out of one reduction with no data-dependent
+ * branch: four slots per compare, greater-than lanes summed via popcount of the byte mask.
+ */
+static inline auto InternalLeScanInt64(const char *keys, int lo, int hi, int64_t target) -> int {
+  const __m256i needle = _mm256_set1_epi64x(target);
+  int gt_bytes = 0;
+  int i = lo;
+  for (; i + 4 <= hi; i += 4) {
+    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + static_cast<size_t>(i) * 8));
+    gt_bytes += __builtin_popcount(_mm256_movemask_epi8(_mm256_cmpgt_epi64(chunk, needle)));
+  }
+  int le = (i - lo) - gt_bytes / 8;  // each greater lane contributes 8 mask bytes
+  for (; i < hi; i++) {
+    int64_t k;
+    std::memcpy(&k, keys + static_cast<size_t>(i) * 8, sizeof(k));
+    le += static_cast<int>(k <= target);
+  }
+  return le;
+}
+#endif
+
 /**
  *
  * @param key The key to search for
@@ -591,19 +922,92 @@ auto BPLUSTREE_TYPE::ToPrintableBPlusTree(page_id_t root_id) -> PrintableBPlusTr
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::InternalKeyIndex(const InternalPage *page, const KeyType &key) const -> int {
-  int i = 1;
-  for (; i < page->GetSize(); i++) {
-    KeyType k = page->KeyAt(i);
-    if (comparator_(key, k) < 0) {
-      return i - 1;
+#ifdef __AVX2__
+  // the common index shape keeps the slot keys as a contiguous int64 array, so descend with
+  // the cmov binary search only until the window fits a few vector compares, then resolve it
+  // with one branch-free counting scan instead of the last hard-to-predict partition steps
+  if constexpr (std::is_same_v<KeyType, GenericKey<8>>) {
+    if (comparator_.IsSingleBigint()) {
+      int64_t target;
+      std::memcpy(&target, key.data_, sizeof(target));
+      const auto *keys = reinterpret_cast<const char *>(page->Keys());
+      int base = 0;
+      int len = page->GetSize();
+      while (len > BINARY_SEARCH_THRESHOLD) {
+        const int half = len / 2;
+        __builtin_prefetch(keys + static_cast<size_t>(base + half / 2) * 8);
+        __builtin_prefetch(keys + static_cast<size_t>(base + half + half / 2) * 8);
+        int64_t mid;
+        std::memcpy(&mid, keys + static_cast<size_t>(base + half) * 8, sizeof(mid));
+        base = target < mid ? base : base + half;
+        len -= half;
+      }
+      // slot base is already known to be <= the search key (slot 0 is the -inf sentinel)
+      return base + InternalLeScanInt64(keys, base + 1, base + len, target);
+    }
+  }
+#endif
+  if (page->GetMaxSize() >= BINARY_SEARCH_THRESHOLD) {
+    // Branch-free binary search for the last slot whose key is <= the search key; slot 0 acts as
+    // the -inf sentinel (its key is invalid and never compared). The ternary compiles to a cmov,
+    // and both possible next midpoints are prefetched so their loads overlap the current compare.
+    int base = 0;
+    int len = page->GetSize();
+    while (len > 1) {
+      const int half = len / 2;
+      __builtin_prefetch(&page->Keys()[base + half / 2]);
+      __builtin_prefetch(&page->Keys()[base + half + half / 2]);
+      base = comparator_(key, page->KeyAt(base + half)) < 0 ? base : base + half;
+      len -= half;
+    }
+    return base;
+  }
+  // Branchless scan for small nodes: since keys are sorted, the answer equals the number of keys
+  // at or below the search key, so count them all instead of breaking on the first larger one.
+  // The loop body has no data-dependent branch, random search keys cost no mispredictions, and
+  // the compiler can vectorize the accumulation once the comparator inlines.
+  const int n = page->GetSize();
+  int idx = 0;
+  for (int i = 1; i < n; i++) {
+    idx += static_cast<int>(comparator_(key, page->KeyAt(i)) >= 0);
+  }
+  return idx;
+}
+
+#ifdef __AVX2__
+/**
+ * Equality scan over a leaf's interleaved (key, rid) slots for raw int64 keys. Each 256-bit
+ * load covers two 16-byte slots, whose keys sit in lanes 0 and 2; the record-id lanes are
+ * masked out of both compares. A nonzero equality mask pinpoints the slot via the count of
+ * trailing zero bytes, and because the slots are sorted a greater-than hit means no later
+ * slot can match, so a miss usually exits within the first couple of loads.
+ */
+static inline auto LeafEqScanInt64(const void *slots, int n, int64_t target) -> int {
+  constexpr int kKeyLanes = 0x00FF00FF;  // byte mask selecting lanes 0 and 2 of the movemask
+  const auto *base = static_cast<const char *>(slots);
+  const __m256i needle = _mm256_set1_epi64x(target);
+  int i = 0;
+  for (; i + 2 <= n; i += 2) {
+    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(base + static_cast<size_t>(i) * 16));
+    const int eq = _mm256_movemask_epi8(_mm256_cmpeq_epi64(chunk, needle)) & kKeyLanes;
+    if (eq != 0) {
+      return i + (__builtin_ctz(eq) >> 4);  // trailing zero byte 0 -> slot i, byte 16 -> slot i+1
+    }
+    const int gt = _mm256_movemask_epi8(_mm256_cmpgt_epi64(chunk, needle)) & kKeyLanes;
+    if (gt != 0) {
+      return -1;  // this pair is already past the target
     }
   }
-  // larger than any key
-  if (i == page->GetSize()) {
-    return page->GetSize() - 1;
+  if (i < n) {  // odd slot count: one scalar check for the last slot
+    int64_t last;
+    std::memcpy(&last, base + static_cast<size_t>(i) * 16, sizeof(last));
+    if (last == target) {
+      return i;
+    }
   }
-  return 0;
+  return -1;
 }
+#endif
 
 /**
  *
@@ -612,13 +1016,74 @@ auto BPLUSTREE_TYPE::InternalKeyIndex(const InternalPage *page, const KeyType &k
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::LeafKeyIndex(const LeafPage *leaf, const KeyType &key) const -> int {
-  for (int i = 0; i < leaf->GetSize(); i++) {
-    KeyType k = leaf->KeyAt(i);
-    if (comparator_(key, k) == 0) {
-      return i;
+  const int n = leaf->GetSize();
+#ifdef __AVX2__
+  // point lookups on the common index shape (8-byte raw int64 keys, 16-byte slots) take the
+  // vector scan; everything else keeps the comparator-based searches below
+  if constexpr (std::is_same_v<KeyType, GenericKey<8>> && sizeof(MappingType) == 2 * sizeof(int64_t)) {
+    if (comparator_.IsSingleBigint()) {
+      int64_t target;
+      std::memcpy(&target, key.data_, sizeof(target));
+      return LeafEqScanInt64(&leaf->GetMapping(0), n, target);
     }
   }
-  return -1;
+#endif
+  if (leaf->GetMaxSize() >= BINARY_SEARCH_THRESHOLD) {
+    // binary search for the last slot with a key <= the search key, then one equality check;
+    // same branch-free partition step with midpoint prefetch as InternalKeyIndex
+    if (n == 0 || comparator_(key, leaf->KeyAt(0)) < 0) {
+      return -1;
+    }
+    int base = 0;
+    int len = n;
+    while (len > 1) {
+      const int half = len / 2;
+      __builtin_prefetch(&leaf->GetMapping(base + half / 2));
+      __builtin_prefetch(&leaf->GetMapping(base + half + half / 2));
+      base = comparator_(key, leaf->KeyAt(base + half)) < 0 ? base : base + half;
+      len -= half;
+    }
+    return comparator_(key, leaf->KeyAt(base)) == 0 ? base : -1;
+  }
+  // same branchless form as InternalKeyIndex: a conditional move per slot instead of a
+  // break, so a miss (the common case for point lookups) costs no mispredicted exit
+  int idx = -1;
+  for (int i = 0; i < n; i++) {
+    idx = comparator_(key, leaf->KeyAt(i)) == 0 ? i : idx;
+  }
+  return idx;
+}
+
+/**
+ *
+ * @param key The key to insert
+ * @return i, the slot the key should be inserted at (k[i] == key if the key already exists)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::LeafInsertIndex(const LeafPage *leaf, const KeyType &key) const -> int {
+  const int n = leaf->GetSize();
+  if (leaf->GetMaxSize() >= BINARY_SEARCH_THRESHOLD) {
+    if (n == 0 || comparator_(key, leaf->KeyAt(0)) <= 0) {
+      return 0;
+    }
+    // last slot with a key strictly below the search key, plus one
+    int base = 0;
+    int len = n;
+    while (len > 1) {
+      const int half = len / 2;
+      __builtin_prefetch(&leaf->GetMapping(base + half / 2));
+      __builtin_prefetch(&leaf->GetMapping(base + half + half / 2));
+      base = comparator_(key, leaf->KeyAt(base + half)) <= 0 ? base : base + half;
+      len -= half;
+    }
+    return base + 1;
+  }
+  // branchless count of the keys strictly below the search key
+  int idx = 0;
+  for (int i = 0; i < n; i++) {
+    idx += static_cast<int>(comparator_(key, leaf->KeyAt(i)) > 0);
+  }
+  return idx;
 }
 
 /**
@@ -636,36 +1101,39 @@ auto BPLUSTREE_TYPE::IsSafeModify(const BPlusTreePage *page, bool isInsert) cons
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::MoveLeafChild(LeafPage *fromPage, int fromPos, LeafPage *ToPage, int toPos, int size) {
-  for (; size > 0; --size) {  // move kv
-    ToPage->SetKeyAt(toPos, fromPage->KeyAt(fromPos));
-    ToPage->SetValueAt(toPos, fromPage->ValueAt(fromPos));
-    --fromPos;
-    --toPos;
-  }
+  // the slots are one contiguous mapping array, so the per-element copy loop is really a byte
+  // shuffle; a single memmove also stays correct for the overlapping shift inside one page.
+  // The mapping pair is not formally trivially copyable (std::pair's assignment operators are
+  // user-provided), but both halves are, so every raw byte move of leaf slots in this file is
+  // sound — and goes through void * to keep -Wclass-memaccess quiet about the pair type.
+  static_assert(std::is_trivially_copyable_v<KeyType> && std::is_trivially_copyable_v<ValueType>,
+                "leaf slots are moved as raw bytes");
+  auto *src = fromPage->GetArray() + fromPos - size + 1;
+  auto *dst = ToPage->GetArray() + toPos - size + 1;
+  std::memmove(static_cast<void *>(dst), static_cast<const void *>(src), static_cast<size_t>(size) * sizeof(*src));
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::MoveInternalChild(InternalPage *fromPage, int fromPos, InternalPage *ToPage, int toPos, int size) {
-  for (; size > 0; --size) {  // move kv
-    ToPage->SetKeyAt(toPos, fromPage->KeyAt(fromPos));
-    ToPage->SetValueAt(toPos, fromPage->ValueAt(fromPos));
-    --fromPos;
-    --toPos;
-  }
+  // keys and child ids live in separate arrays, so the move is two bulk copies
+  std::memmove(ToPage->Keys() + toPos - size + 1, fromPage->Keys() + fromPos - size + 1,
+               static_cast<size_t>(size) * sizeof(KeyType));
+  std::memmove(ToPage->Values() + toPos - size + 1, fromPage->Values() + fromPos - size + 1,
+               static_cast<size_t>(size) * sizeof(page_id_t));
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::SplitLeaf(LeafPage *leaf) -> page_id_t {
-  page_id_t pid;
+auto BPLUSTREE_TYPE::SplitLeaf(LeafPage *leaf, BasicPageGuard &&guard) -> page_id_t {
+  auto pid = guard.PageId();
   auto newSize = leaf->GetMinSize();
   auto remainSize = leaf->GetSize() - newSize;
-  auto guard = bpm_->NewPageGuarded(&pid);
   auto leaf2 = reinterpret_cast<LeafPage *>(guard.GetDataMut());
   // init for new page
   leaf2->Init(leaf_max_size_);
   leaf2->SetSize(newSize);
-  // copy child
-  MoveLeafChild(leaf, leaf->GetSize() - 1, leaf2, leaf2->GetSize() - 1, newSize);
+  // copy the right half; the two pages never alias, so this can be memcpy rather than memmove
+  std::memcpy(static_cast<void *>(leaf2->GetArray()), static_cast<const void *>(leaf->GetArray() + remainSize),
+              static_cast<size_t>(newSize) * sizeof(*leaf2->GetArray()));
   leaf->SetSize(remainSize);
   return pid;
 }
@@ -680,27 +1148,34 @@ auto BPLUSTREE_TYPE::SplitInternal(InternalPage *internal) -> page_id_t {
   // init for new page
   internal2->Init(internal_max_size_);
   internal2->SetSize(newSize);
-  // copy child
-  MoveInternalChild(internal, internal->GetSize() - 1, internal2, internal2->GetSize() - 1, newSize);
+  // copy the right half; the two pages never alias, so this can be memcpy rather than memmove
+  std::memcpy(internal2->Keys(), internal->Keys() + remainSize, static_cast<size_t>(newSize) * sizeof(KeyType));
+  std::memcpy(internal2->Values(), internal->Values() + remainSize, static_cast<size_t>(newSize) * sizeof(page_id_t));
   internal->SetSize(remainSize);
   return pid;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertIntoLeaf(LeafPage *leaf, int i, const KeyType &key, const ValueType &value) {
+  // one bulk shift plus one slot store, instead of a per-slot copy loop and separate key/value writes
+  auto *a = leaf->GetArray();
+  auto n = leaf->GetSize();
+  std::memmove(static_cast<void *>(a + i + 1), static_cast<const void *>(a + i),
+               static_cast<size_t>(n - i) * sizeof(*a));
+  a[i] = {key, value};
   leaf->IncreaseSize(1);
-  MoveLeafChild(leaf, leaf->GetSize() - 1 - 1, leaf, leaf->GetSize() - 1, leaf->GetSize() - 1 - i);
-  leaf->SetKeyAt(i, key);
-  leaf->SetValueAt(i, value);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertIntoInternal(InternalPage *internal, int i, const KeyType &key, const page_id_t value) {
+  auto *keys = internal->Keys();
+  auto *values = internal->Values();
+  auto n = internal->GetSize();
+  std::memmove(keys + i + 1, keys + i, static_cast<size_t>(n - i) * sizeof(KeyType));
+  std::memmove(values + i + 1, values + i, static_cast<size_t>(n - i) * sizeof(page_id_t));
+  keys[i] = key;
+  values[i] = value;
   internal->IncreaseSize(1);
-  MoveInternalChild(internal, internal->GetSize() - 1 - 1, internal, internal->GetSize() - 1,
-                    internal->GetSize() - 1 - i);
-  internal->SetKeyAt(i, key);
-  internal->SetValueAt(i, value);
 }
 
 template class BPlusTree<GenericKey<4>, RID, GenericComparator<4>>;
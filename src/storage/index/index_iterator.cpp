@@ -44,6 +44,11 @@ auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
   ++pos_;
   auto leaf = reinterpret_cast<const B_PLUS_TREE_LEAF_PAGE_TYPE *>(guard_.GetData());
   if (pos_ < leaf->GetSize()) {
+    // halfway through the leaf, start warming the buffer pool's lookup path for the next one
+    // so the crossing below finds its cache lines resident
+    if (pos_ == leaf->GetSize() / 2 && leaf->GetNextPageId() != INVALID_PAGE_ID) {
+      bpm_->PrefetchPage(leaf->GetNextPageId());
+    }
     return *this;
   }
   pos_ = 0;
@@ -51,8 +56,8 @@ auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
     guard_.Drop();
     return *this;  // reached end
   }
-  // try next page
-  auto guard_ = bpm_->FetchPageRead(leaf->GetNextPageId());
+  // try next page; the fetch latches the next leaf before the assignment releases this one
+  guard_ = bpm_->FetchPageRead(leaf->GetNextPageId());
   return *this;
 }
 
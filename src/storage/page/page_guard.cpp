@@ -9,6 +9,9 @@ BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept
       is_dirty_(std::exchange(that.is_dirty_, false)) {}
 
 void BasicPageGuard::Drop() {
+  if (page_ == nullptr) {  // moved-from or already dropped
+    return;
+  }
   bpm_->UnpinPage(page_->GetPageId(), is_dirty_);
   bpm_ = nullptr;
   page_ = nullptr;
@@ -55,6 +58,9 @@ auto ReadPageGuard::PageId() const -> page_id_t {
 }
 
 void ReadPageGuard::Drop() {
+  if (guard_.page_ == nullptr) {  // moved-from or already dropped
+    return;
+  }
   guard_.page_->RUnlatch();
   guard_.Drop();
 }
@@ -82,6 +88,9 @@ auto WritePageGuard::operator=(WritePageGuard &&that) noexcept -> WritePageGuard
 }
 
 void WritePageGuard::Drop() {
+  if (guard_.page_ == nullptr) {  // moved-from or already dropped
+    return;
+  }
   guard_.page_->WUnlatch();
   guard_.Drop();
 }